@@ -3,41 +3,12 @@
 BallObject::BallObject()
 	: GameObject(), Radius(12.5f), Stuck(true), Sticky(false), PassThrough(false) {}
 
-BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite)
-	: GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f), sprite, glm::vec3(1.0f), velocity), Radius(radius), Stuck(true), Sticky(false), PassThrough(false){}
-
-glm::vec2 BallObject::Move(float dt, unsigned int window_width) {
-
-	//If not stuck to the player paddle
-	if (!this->Stuck) {
-
-		//Move the ball
-		this->Position += this->Velocity * dt;
-
-		//Check if outside window bounds and if so, reverse velocity and restore at correct position
-		if (this->Position.x <= 0.0f) { //left-x
-			this->Velocity.x = -this->Velocity.x;
-			this->Position.x = 0.0f;
-		}
-		else if (this->Position.x + this->Size.x >= window_width) { //right-x
-			this->Velocity.x = -this->Velocity.x;
-			this->Position.x = window_width - this->Size.x;
-		}
-
-		//Vertical
-		if (this->Position.y <= 0.0f) { //top
-			this->Velocity.y = -this->Velocity.y;
-			this->Position.y = 0.0f;
-		}
-
-	}
-
-	return this->Position;
-}
+BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity)
+	: GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f), glm::vec3(1.0f), velocity), Radius(radius), Stuck(true), Sticky(false), PassThrough(false){}
 
 //Reset the ball to initial stuck position (if ball is outside the window's bounds
 void BallObject::Reset(glm::vec2 position, glm::vec2 velocity) {
-	this->Position = position;
+	this->Position = this->PreviousPosition = position;
 	this->Velocity = velocity;
 	this->Stuck = true;
 }
\ No newline at end of file
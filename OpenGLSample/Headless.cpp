@@ -0,0 +1,224 @@
+//Headless Breakout runner.
+//Links only the simulation core (no OpenGL, GLFW or irrKlang) and runs
+//the game as fast as the CPU allows, either with a simple paddle
+//autopilot or by playing back a recorded replay.
+//Usage: Headless [frames] [level] [seed] [balls] [ball contacts 0/1]
+//       Headless --replay <file>
+//       Headless --bench-collision [bricks] [circles]
+
+#include "collision_simd.hpp"
+#include "game.hpp"
+#include "replay.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+//Counts simulation events for the end-of-run report
+class EventCounter : public GameListener
+{
+public:
+    unsigned int BricksDestroyed = 0;
+    unsigned int SolidHits = 0;
+    unsigned int PaddleHits = 0;
+    unsigned int PowerUpsActivated = 0;
+
+    void OnBrickDestroyed(const GameLevel& level, unsigned int brick) override { ++BricksDestroyed; }
+    void OnSolidBrickHit(const GameLevel& level, unsigned int brick) override { ++SolidHits; }
+    void OnPaddleHit(const GameObject& paddle) override { ++PaddleHits; }
+    void OnPowerUpActivated(const PowerUp& powerUp) override { ++PowerUpsActivated; }
+};
+
+//Wall-clock cost of single simulation steps
+struct StepTimer
+{
+    double Total = 0.0, Max = 0.0;
+    uint64_t Steps = 0;
+
+    void Add(double seconds)
+    {
+        Total += seconds;
+        if (seconds > Max)
+            Max = seconds;
+        ++Steps;
+    }
+};
+
+//Mirrors the window layer's key callback
+void SetKey(Game& game, unsigned int key, bool pressed)
+{
+    game.Keys[key] = pressed;
+    if (!pressed)
+        game.KeysProcessed[key] = false;
+}
+
+//Autopilot: leave the menu/win screens, launch the ball(s) (stress mode: until there
+//are at least 'balls' in play) and keep the paddle under the lowest falling ball
+void AutoPilot(Game& game, unsigned int balls)
+{
+    SetKey(game, KEY_ENTER, game.State != GAME_ACTIVE && game.Tick % 2 == 0);
+    SetKey(game, KEY_B, game.State == GAME_ACTIVE && game.Balls.size() < balls && game.Tick % 2 == 0);
+
+    const BallObject* lowest = &game.Balls[0];
+    for (const BallObject& ball : game.Balls)
+        if (ball.Velocity.y > 0.0f && (lowest->Velocity.y <= 0.0f || ball.Position.y > lowest->Position.y))
+            lowest = &ball;
+
+    float paddleCenter = game.Player->Position.x + game.Player->Size.x / 2.0f;
+    float ballCenter = lowest->Position.x + lowest->Radius;
+    SetKey(game, KEY_SPACE, true);
+    SetKey(game, KEY_A, ballCenter < paddleCenter - 10.0f);
+    SetKey(game, KEY_D, ballCenter > paddleCenter + 10.0f);
+}
+
+//Microbenchmark: circle vs. AABB overlap tests with the per-brick scalar code,
+//the portable batch kernel and the SIMD batch kernel, on random boxes
+int BenchCollision(unsigned int brickCount, unsigned int circleCount)
+{
+    Random rng;
+    rng.Seed(1);
+
+    std::vector<glm::vec2> positions(brickCount), sizes(brickCount);
+    std::vector<unsigned int> indices(brickCount);
+    for (unsigned int i = 0; i < brickCount; ++i)
+    {
+        positions[i] = glm::vec2(rng.NextFloat() * 800.0f, rng.NextFloat() * 600.0f);
+        sizes[i] = glm::vec2(20.0f + rng.NextFloat() * 60.0f, 10.0f + rng.NextFloat() * 30.0f);
+        indices[i] = i;
+    }
+    std::vector<AABBPack> packs;
+    PackAABBs(positions.data(), sizes.data(), indices.data(), brickCount, packs);
+
+    std::vector<glm::vec2> centers(circleCount);
+    for (glm::vec2& center : centers)
+        center = glm::vec2(rng.NextFloat() * 800.0f, rng.NextFloat() * 600.0f);
+    const float radius = 12.5f;
+
+    //Per brick: closest point on the box, then distance and push-out direction
+    auto scalar = [&]() {
+        unsigned int hits = 0;
+        float depth = 0.0f;
+        for (glm::vec2 center : centers)
+            for (unsigned int i = 0; i < brickCount; ++i)
+            {
+                glm::vec2 difference = center - glm::clamp(center, positions[i], positions[i] + sizes[i]);
+                float distance = glm::length(difference);
+                if (distance < radius)
+                {
+                    ++hits;
+                    depth += radius - distance;
+                }
+            }
+        return std::make_pair(hits, depth);
+    };
+
+    //8 bricks at a time, using the penetration data of the hit lanes
+    auto batch = [&](unsigned int (*kernel)(glm::vec2, float, const AABBPack&, CircleHits*)) {
+        unsigned int hits = 0;
+        float depth = 0.0f;
+        CircleHits result;
+        for (glm::vec2 center : centers)
+            for (const AABBPack& pack : packs)
+                for (unsigned int mask = kernel(center, radius, pack, &result); mask; mask &= mask - 1)
+                {
+                    ++hits;
+                    depth += result.Depth[LowestBit(mask)];
+                }
+        return std::make_pair(hits, depth);
+    };
+
+    auto run = [&](const char* name, auto test) {
+        auto start = std::chrono::steady_clock::now();
+        auto result = test();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << elapsed.count() * 1e9 / (double(brickCount) * circleCount) << "ns per test, "
+            << result.first << " hits, total depth " << result.second << std::endl;
+        return result.first;
+    };
+
+    unsigned int expected = run("Scalar", scalar);
+    bool match = run("Batch (portable)", [&]() { return batch(CircleVsAABB8Scalar); }) == expected;
+    match = run("Batch (SIMD)", [&]() { return batch(CircleVsAABB8); }) == expected && match;
+
+    if (!match)
+        std::cout << "ERROR::BENCHMARK: Hit counts differ" << std::endl;
+    return match ? 0 : -1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench-collision") == 0)
+        return BenchCollision(argc > 2 ? std::atoi(argv[2]) : 10000, argc > 3 ? std::atoi(argv[3]) : 1000);
+
+    const bool replaying = argc > 2 && std::strcmp(argv[1], "--replay") == 0;
+
+    ReplayPlayer player;
+    unsigned int width = 800, height = 600;
+    uint64_t frames = 100000;
+    unsigned int level = 0;
+    uint64_t seed = 0;
+    unsigned int balls = 1;
+    bool ballContacts = false;
+    float deltaTime = 1.0f / 240.0f;
+
+    if (replaying)
+    {
+        if (!player.Data.Load(argv[2]))
+            return -1;
+        width = player.Data.Width;
+        height = player.Data.Height;
+        frames = player.Data.EndTick;
+        deltaTime = player.Data.StepTime;
+    }
+    else
+    {
+        frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : frames;
+        level = argc > 2 ? std::atoi(argv[2]) : level;
+        seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : seed;
+        balls = argc > 4 ? std::atoi(argv[4]) : balls;
+        ballContacts = argc > 5 && std::atoi(argv[5]) != 0;
+    }
+
+    Game breakout(width, height);
+    breakout.Rng.Seed(seed);
+    breakout.Init();
+    breakout.Level = level % breakout.Levels.size();
+    breakout.BallContacts = ballContacts;
+    if (replaying && !player.Begin(breakout))
+        return -1;
+
+    EventCounter counter;
+    breakout.AddListener(&counter);
+    StepTimer timer;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t frame = 0; frame < frames; ++frame)
+    {
+        if (replaying)
+            player.Apply(breakout);
+        else
+            AutoPilot(breakout, balls);
+
+        auto stepStart = std::chrono::steady_clock::now();
+        breakout.Step(deltaTime);
+        timer.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStart).count());
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Simulated " << frames << " frames in " << elapsed.count() << "s ("
+        << frames / elapsed.count() << " frames/s)" << std::endl;
+    std::cout << "Step time: mean " << timer.Total / timer.Steps * 1e6 << "us, max " << timer.Max * 1e6 << "us" << std::endl;
+    std::cout << "Bricks destroyed: " << counter.BricksDestroyed
+        << ", solid hits: " << counter.SolidHits
+        << ", paddle hits: " << counter.PaddleHits
+        << ", powerups: " << counter.PowerUpsActivated
+        << ", balls in play: " << breakout.Balls.size() << std::endl;
+    const GameLevel& finalLevel = breakout.Levels[breakout.Level];
+    std::cout << "Level progress: " << finalLevel.Progress() * 100.0f << "% ("
+        << finalLevel.DestructibleBricks - finalLevel.RemainingBricks << " of " << finalLevel.DestructibleBricks << " bricks)" << std::endl;
+    return 0;
+}
@@ -1,9 +1,13 @@
 #include "PostProcessor.hpp"
+#include "gl_state.hpp"
+#include "resource_manager.hpp"
 
 #include <iostream>
+#include <string>
+#include <vector>
 
-PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int height)
-	: PostProcessingShader(shader), Texture(), Width(width), Height(height), Confuse(false), Chaos(false), Shake(false)
+PostProcessor::PostProcessor(unsigned int width, unsigned int height)
+	: Texture(), Width(width), Height(height), ActiveEffects(0)
 {
     // initialize renderbuffer/framebuffer object
     glGenFramebuffers(1, &this->MSFBO);
@@ -11,7 +15,7 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
     glGenRenderbuffers(1, &this->RBO);
 
     // initialize renderbuffer storage with a multisampled color buffer (don't need a depth/stencil buffer)
-    glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
     glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
     glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, width, height); // allocate storage for render buffer object
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->RBO); // attach MS render buffer object to framebuffer
@@ -20,17 +24,16 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
         std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
 
     // also initialize the FBO/texture to blit multisampled color-buffer to; used for shader operations (for postprocessing effects)
-    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO);
     this->Texture.Generate(width, height, NULL);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0); // attach texture to framebuffer as its color attachment
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // initialize render data and uniforms
     this->InitRenderData();
-    this->PostProcessingShader.SetInteger("scene", 0, true);
 
     float offset = 1.0f / 300.0f;
     float offsets[9][2] = {
@@ -44,55 +47,87 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
         {  0.0f,   -offset  },  // bottom-center
         {  offset, -offset  }   // bottom-right    
     };
-    glUniform2fv(glGetUniformLocation(this->PostProcessingShader.ID, "offsets"), 9, (float*)offsets);
 
     int edgeKernel[9] = {
         -1, -1, -1,
         -1,  8, -1,
         -1, -1, -1
     };
-    glUniform1iv(glGetUniformLocation(this->PostProcessingShader.ID, "edgeKernel"), 9, edgeKernel);
 
     float blurKernel[9] = {
         1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
         2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
         1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
     };
-    glUniform1fv(glGetUniformLocation(this->PostProcessingShader.ID, "blurKernel"), 9, blurKernel);
+
+    // compile every distinct effect set up front so switching effects never stalls a frame
+    // (no effects is never drawn: the pass is bypassed)
+    for (unsigned int effects = 1; effects < POST_EFFECT_SETS; ++effects)
+    {
+        unsigned int minimal = MinimalEffects(effects);
+        if (minimal != effects)
+        {
+            this->Shaders[effects] = this->Shaders[minimal]; // smaller, so already loaded
+            continue;
+        }
+
+        std::vector<std::string> defines;
+        if (effects & EFFECT_CONFUSE)
+            defines.push_back("CONFUSE");
+        if (effects & EFFECT_CHAOS)
+            defines.push_back("CHAOS");
+        if (effects & EFFECT_SHAKE)
+            defines.push_back("SHAKE");
+        Shader& shader = this->Shaders[effects];
+        shader = ResourceManager::LoadShaderVariant("shaders/postProcessingVertex.glsl", "shaders/postProcessingFragment.glsl", defines, "post");
+
+        // a variant only keeps the kernels it uses (the others' locations are -1 and ignored)
+        shader.SetInteger("scene", 0, true);
+        glUniform2fv(glGetUniformLocation(shader.ID, "offsets"), 9, (float*)offsets);
+        glUniform1iv(glGetUniformLocation(shader.ID, "edgeKernel"), 9, edgeKernel);
+        glUniform1fv(glGetUniformLocation(shader.ID, "blurKernel"), 9, blurKernel);
+    }
 }
 
 void PostProcessor::BeginRender() {
-	glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+
+	//No effect: draw to the (already cleared) default framebuffer
+	if (this->ActiveEffects == 0) {
+		GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+		return;
+	}
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void PostProcessor::EndRender() {
+	if (this->ActiveEffects == 0)
+		return;
+
 	//now resolve multisampled color-buffer into intermediate FBO to store to texture
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
+	GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
 
 	glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->Width, this->Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0); // binds both READ and WRITE framebuffer to default framebuffer
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0); // binds both READ and WRITE framebuffer to default framebuffer
 }
 
-void PostProcessor::Render(float time) {
+void PostProcessor::Render() {
+	if (this->ActiveEffects == 0)
+		return;
 
-	// set uniforms/options
-	this->PostProcessingShader.Use();
-	this->PostProcessingShader.SetFloat("time", time);
-	this->PostProcessingShader.SetInteger("confuse", this->Confuse);
-	this->PostProcessingShader.SetInteger("chaos", this->Chaos);
-	this->PostProcessingShader.SetInteger("shake", this->Shake);
+	// the variant compiled for exactly these effects (time comes from the frame uniform block)
+	this->Shaders[this->ActiveEffects % POST_EFFECT_SETS].Use();
 
 	// render textured quad
-	glActiveTexture(GL_TEXTURE0);
+	GLState::ActiveTexture(0);
 	this->Texture.Bind();
 
-	glBindVertexArray(this->VAO);
+	GLState::BindVertexArray(this->VAO);
 	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindVertexArray(0);
 }
 
 void PostProcessor::InitRenderData() {
@@ -112,12 +147,20 @@ void PostProcessor::InitRenderData() {
 	glGenVertexArrays(1, &this->VAO);
 	glGenBuffers(1, &VBO);
 
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	GLState::BindArrayBuffer(VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-	glBindVertexArray(this->VAO);
+	GLState::BindVertexArray(this->VAO);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	GLState::BindArrayBuffer(0);
+	GLState::BindVertexArray(0);
+}
+
+unsigned int PostProcessor::MinimalEffects(unsigned int effects) {
+
+	//chaos replaces confuse's texture coordinates and colors, so confuse adds nothing to it
+	if (effects & EFFECT_CHAOS)
+		effects &= ~EFFECT_CONFUSE;
+	return effects;
 }
\ No newline at end of file
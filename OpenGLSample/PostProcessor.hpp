@@ -8,25 +8,37 @@
 #include "sprite_renderer.hpp"
 #include "shader.hpp"
 
+//Effects the post processor can apply (bits of PostProcessor::ActiveEffects)
+enum PostEffect {
+	EFFECT_CONFUSE = 1,
+	EFFECT_CHAOS = 2,
+	EFFECT_SHAKE = 4
+};
+
+//Effect sets (every combination of PostEffect bits)
+const unsigned int POST_EFFECT_SETS = 8;
+
 //Hosts all Post Processing effects for Breakout.
-//Renders out to a textured quad after which one can enable
-//specific effects by enabling the booleans.
+//Renders out to a textured quad, timed through the frame uniform block (FrameData).
+//Every effect set has its own shader variant with only that set's code
+//compiled in, so the fragment shader doesn't branch per pixel.
 //Must call BeginRender() before rendering
 //Must call EndRedner() after Rendering
+//While no effect is enabled all three skip the offscreen pass: the scene
+//is drawn straight into the default framebuffer and nothing is blitted.
 class PostProcessor {
 
 public:
 	//State
-	Shader PostProcessingShader;
 	Texture2D Texture;
 
 	unsigned int Width, Height;
 
-	//Options
-	bool Confuse, Chaos, Shake;
+	//PostEffect bits on this frame; none renders straight to the screen
+	unsigned int ActiveEffects;
 
-	//Constructor
-	PostProcessor(Shader shader, unsigned int width, unsigned int height);
+	//Constructor (compiles the shader variants)
+	PostProcessor(unsigned int width, unsigned int height);
 
 	//Prepare the Post Processor's Framebuffer Ops before rendering
 	void BeginRender();
@@ -35,9 +47,13 @@ public:
 	void EndRender();
 
 	//Render the PostProcessor texture Quad
-	void Render(float time);
+	void Render();
 
 private:
+	//Shader variant of each effect set; sets that look the same share one
+	//(chaos overrides confuse)
+	Shader Shaders[POST_EFFECT_SETS];
+
 	//Render state
 	unsigned int MSFBO, FBO; //MSBO - Multisampled FBO.
 	unsigned int RBO; //RBO - Multisampled color buffer
@@ -45,6 +61,9 @@ private:
 
 	//Init Quad
 	void InitRenderData();
+
+	//The effect set that renders the same as the given one with the least shader code
+	static unsigned int MinimalEffects(unsigned int effects);
 };
 
 
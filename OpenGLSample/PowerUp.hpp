@@ -3,7 +3,6 @@
 
 #include <string>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "game_object.hpp"
@@ -29,8 +28,8 @@ public:
 	bool Activated;
 
 	//Constructor
-	PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D texture)
-		: GameObject(position, POWERUP_SIZE, texture, color, VELOCITY), Type(type), Duration(duration), Activated() {}
+	PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position)
+		: GameObject(position, POWERUP_SIZE, color, VELOCITY), Type(type), Duration(duration), Activated() {}
 };
 
 #endif
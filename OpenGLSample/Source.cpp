@@ -2,8 +2,14 @@
 #include <GLFW/glfw3.h>
 
 #include "game.hpp"
+#include "game_renderer.hpp"
+#include "game_audio.hpp"
 #include "resource_manager.hpp"
+#include "gl_state.hpp"
+#include "replay.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 
 //GLFW Callbacks
@@ -14,9 +20,22 @@ void key_callback(GLFWwindow* window, int key, int scanCode, int action, int mod
 const unsigned int SCREEN_WIDTH = 800;
 const unsigned int SCREEN_HEIGHT = 600;
 
+//Fixed simulation rate; rendering interpolates between steps
+const double SIM_STEP = 1.0 / 240.0;
+
+//Longest frame the simulation catches up on, so a hitch can't snowball into ever longer frames
+const double MAX_FRAME_TIME = 0.25;
+
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
-int main()
+//Set by F2; the render loop switches the particle backend
+bool ToggleParticleBackend = false;
+
+//Set by F3; the render loop prints the frame's render statistics
+bool PrintRenderStats = false;
+
+//Usage: MyScene [--gpu-particles] [--record <replay file to record this session into>]
+int main(int argc, char* argv[])
 {
     // glfw: initialize and configure
     // ------------------------------
@@ -31,6 +50,9 @@ int main()
 
     glfwWindowHint(GLFW_RESIZABLE, false);
 
+    //Multisampled like the post processor's buffer, so the scene looks the same when it's drawn straight to the screen
+    glfwWindowHint(GLFW_SAMPLES, 4);
+
     // glfw window creation
     // --------------------
     GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Breakout - Christopher Roelle", NULL, NULL);
@@ -56,38 +78,90 @@ int main()
 
     glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    //Init the Game
+    //Init the Game (a new seed every run; logged so a session can be reproduced)
+    Breakout.Rng.Seed(glfwGetTimerValue());
+    std::cout << "Seed: " << Breakout.Rng.GetSeed() << std::endl;
     Breakout.Init();
 
-    //Delta Time
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    //Record the session's input (only if asked to) so it can be played back headlessly
+    const char* replayFile = nullptr;
+    bool gpuParticles = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--gpu-particles") == 0)
+            gpuParticles = true;
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            replayFile = argv[++i];
+        else
+            std::cout << "Ignoring unknown argument " << argv[i] << std::endl;
+    }
+    ReplayRecorder recorder;
+    if (replayFile)
+        recorder.Begin(Breakout, static_cast<float>(SIM_STEP));
+
+    //Rendering and audio observe the simulation
+    GameRenderer* Renderer = new GameRenderer(SCREEN_WIDTH, SCREEN_HEIGHT);
+    GameAudio* Audio = new GameAudio();
+    Breakout.AddListener(Audio);
+    Breakout.AddListener(Renderer->Particles);
+    if (gpuParticles)
+        Renderer->Particles->SetBackend(PARTICLES_GPU);
+    std::cout << "Particles: " << (Renderer->Particles->GetBackend() == PARTICLES_GPU ? "GPU" : "CPU") << " (F2 to switch)" << std::endl;
+    Audio->PlayMusic();
+
+    //Monotonic 64-bit clock
+    const uint64_t timerFrequency = glfwGetTimerFrequency();
+    const uint64_t startTime = glfwGetTimerValue();
+    uint64_t lastFrame = startTime;
+
+    //Simulation time not yet consumed by fixed steps
+    double accumulator = 0.0;
 
     // render loop
     // -----------
     while (!glfwWindowShouldClose(window))
     {
-        //Calculate Delta Time
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
+        //Calculate Frame Time
+        uint64_t currentFrame = glfwGetTimerValue();
+        double frameTime = static_cast<double>(currentFrame - lastFrame) / timerFrequency;
         lastFrame = currentFrame;
+        if (frameTime > MAX_FRAME_TIME)
+            frameTime = MAX_FRAME_TIME;
+        accumulator += frameTime;
         glfwPollEvents();
 
-        // input
-        // -----
-        Breakout.ProcessInput(deltaTime);
+        //Switch particle backends between frames
+        if (ToggleParticleBackend) {
+            ToggleParticleBackend = false;
+            ParticleBackend backend = Renderer->Particles->GetBackend() == PARTICLES_GPU ? PARTICLES_CPU : PARTICLES_GPU;
+            if (Renderer->Particles->SetBackend(backend))
+                std::cout << "Particles: " << (backend == PARTICLES_GPU ? "GPU" : "CPU") << std::endl;
+        }
 
-        // Update Game State
+        // input + Update Game State in fixed steps
         // -----
-        Breakout.Update(deltaTime);
+        while (accumulator >= SIM_STEP)
+        {
+            if (replayFile)
+                recorder.Capture(Breakout);
+            Breakout.Step(static_cast<float>(SIM_STEP));
+            accumulator -= SIM_STEP;
+        }
+        Renderer->Update(Breakout, static_cast<float>(frameTime));
 
         // render
         // ------
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        Breakout.Render();
+        double time = static_cast<double>(currentFrame - startTime) / timerFrequency;
+        Renderer->Render(Breakout, time, static_cast<float>(accumulator / SIM_STEP));
+
+        if (PrintRenderStats) {
+            PrintRenderStats = false;
+            std::cout << "Render: " << Renderer->Queue->Commands << " commands, " << Renderer->Queue->StateChanges << " state changes, GL binds "
+                << GLState::Issued << " issued / " << GLState::Skipped << " skipped" << std::endl;
+        }
 
         // glfw: swap buffers
         // ------------------
@@ -96,6 +170,10 @@ int main()
 
     // optional: de-allocate all resources once they've outlived their purpose:
     // ------------------------------------------------------------------------
+    delete Renderer;
+    delete Audio;
+    if (replayFile)
+        recorder.Save(Breakout, replayFile);
     ResourceManager::Clear();
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -112,8 +190,18 @@ void key_callback(GLFWwindow* window, int key, int scanCode, int action, int mod
         glfwSetWindowShouldClose(window, true);
     }
 
+    //F2 switches between CPU and GPU particles
+    if (key == GLFW_KEY_F2 && action == GLFW_PRESS) {
+        ToggleParticleBackend = true;
+    }
+
+    //F3 prints the last frame's render statistics
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        PrintRenderStats = true;
+    }
+
     //Manage if a key is pressed and pass that the key is down to the Game obj
-    if (key >= 0 && key < 1024) {
+    if (key >= 0 && key < static_cast<int>(GAME_KEYS)) {
         if (action == GLFW_PRESS) {
             Breakout.Keys[key] = true;
         }
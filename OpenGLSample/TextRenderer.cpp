@@ -1,34 +1,114 @@
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
 #include <iostream>
 
-#include <glm/gtc/matrix_transform.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 #include "TextRenderer.hpp"
 #include "resource_manager.hpp"
+#include "texture_atlas.hpp"
+#include "gl_state.hpp"
 
-TextRenderer::TextRenderer(unsigned int width, unsigned int height) 
+TextObject::TextObject(float x, float y, float scale, glm::vec3 color)
+    : x(x), y(y), scale(scale), color(color), generation(0)
 {
-    // load and configure shader
+}
+
+void TextObject::SetText(std::string_view text)
+{
+    if (text == this->text)
+        return;
+    this->text.assign(text.data(), text.size()); // reuses the string's storage unless the text grew
+    this->generation = 0;
+}
+
+void TextObject::SetText(std::string_view prefix, long long number)
+{
+    // prefix and digits in a fixed buffer on the stack
+    char buffer[64];
+    size_t length = std::min(prefix.size(), sizeof(buffer) - 20);
+    std::copy(prefix.begin(), prefix.begin() + length, buffer);
+    std::to_chars_result result = std::to_chars(buffer + length, buffer + sizeof(buffer), number);
+    this->SetText(std::string_view(buffer, result.ptr - buffer));
+}
+
+void TextObject::SetPosition(float x, float y)
+{
+    if (x == this->x && y == this->y)
+        return;
+    this->x = x;
+    this->y = y;
+    this->generation = 0;
+}
+
+void TextObject::SetScale(float scale)
+{
+    if (scale == this->scale)
+        return;
+    this->scale = scale;
+    this->generation = 0;
+}
+
+void TextObject::SetColor(glm::vec3 color)
+{
+    if (color == this->color)
+        return;
+    this->color = color;
+    this->generation = 0;
+}
+
+TextRenderer::TextRenderer() 
+    : Characters(), DrawCalls(0), generation(0), capHeight(0.0f)
+{
+    // load and configure shader (the projection comes from the frame uniform block)
     this->TextShader = ResourceManager::LoadShader("shaders/textVertex.glsl", "shaders/textFragment.glsl", nullptr, "text");
-    this->TextShader.SetMatrix4("projection", glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f), true);
-    this->TextShader.SetInteger("text", 0);
-    // configure VAO/VBO for texture quads
+    this->TextShader.SetInteger("text", 0, true);
+
+    // two triangles per glyph quad, the same for every batch
+    std::vector<unsigned int> indices;
+    indices.reserve(MAX_BATCH_GLYPHS * 6);
+    for (unsigned int quad = 0; quad < MAX_BATCH_GLYPHS; ++quad)
+    {
+        unsigned int first = quad * 4;
+        unsigned int quadIndices[] = { first + 3, first + 1, first, first + 3, first + 2, first + 1 };
+        indices.insert(indices.end(), quadIndices, quadIndices + 6);
+    }
+    this->vertices.reserve(MAX_BATCH_GLYPHS * 4);
+
+    // configure VAO/VBO for the glyph quads (vertices are streamed in by Flush)
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &this->EBO);
+    GLState::BindVertexArray(this->VAO);
+    GLState::BindArrayBuffer(this->VBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_GLYPHS * 4 * sizeof(TextVertex), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, Position)); // position + texcoords
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, Color));
+    GLState::BindVertexArray(0);
+    GLState::BindArrayBuffer(0);
+}
+
+TextRenderer::~TextRenderer()
+{
+    glDeleteVertexArrays(1, &this->VAO);
+    glDeleteBuffers(1, &this->VBO);
+    glDeleteBuffers(1, &this->EBO);
+    glDeleteTextures(1, &this->Atlas.ID);
 }
 
 void TextRenderer::Load(std::string font, unsigned int fontSize) 
 {
     //Clear the previous loaded characters
-    this->Characters.clear();
+    for (Character& character : this->Characters)
+        character = Character();
+    this->capHeight = 0.0f;
+    ++this->generation;
 
     //init and load the FreeType Lib
     FT_Library ft;
@@ -44,107 +124,173 @@ void TextRenderer::Load(std::string font, unsigned int fontSize)
     //Set size to load glphs as
     FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-    //Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    //Atlas page big enough for every glyph at this size (with room to spare for the shelves)
+    unsigned int pageSize = 256;
+    while (pageSize * pageSize < 2 * TEXT_GLYPHS * (fontSize + 4) * (fontSize + 4))
+        pageSize *= 2;
+    TextureAtlas atlas(pageSize, pageSize, 1);
 
-    //Pre-compile/load the first 128 ASCII Characters
-    for (GLubyte c = 0; c < 128; c++) {
+    //Pre-compile/load the first 128 ASCII Characters into the atlas
+    std::vector<unsigned char> rgba;
+    for (unsigned int c = 0; c < TEXT_GLYPHS; c++) {
         
         //Load character glyph
         if (FT_Load_Char(face, c, FT_LOAD_RENDER))
         {
             std::cout << "ERROR::FREETYPE: Failed to load Glyph " << c << std::endl;
+            atlas.Add(0, 0, nullptr);
             continue;
         }
 
-        //Generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        //Store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
-
-        Characters.insert(std::pair<char, Character>(c, character));
-    }
+        //Coverage into the atlas' RGBA format
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        rgba.assign(bitmap.width * bitmap.rows * 4, 0);
+        for (unsigned int y = 0; y < bitmap.rows; ++y)
+            for (unsigned int x = 0; x < bitmap.width; ++x)
+                rgba[(y * bitmap.width + x) * 4] = bitmap.buffer[y * bitmap.pitch + x];
+        atlas.Add(bitmap.width, bitmap.rows, rgba.empty() ? nullptr : rgba.data());
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+        //Store character for later use (its place in the atlas is filled in once packed)
+        Character& character = this->Characters[c];
+        character.Size = glm::ivec2(bitmap.width, bitmap.rows);
+        character.Bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        character.Advance = (face->glyph->advance.x >> 6); // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
+    }
 
     //Destroy FT when finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
+
+    if (!atlas.Pack() || atlas.Pages.size() > 1)
+    {
+        std::cout << "ERROR::FREETYPE: Glyphs don't fit a " << pageSize << "x" << pageSize << " atlas" << std::endl;
+        return;
+    }
+
+    //Keep only the coverage channel
+    std::vector<unsigned char> coverage(pageSize * pageSize);
+    for (size_t i = 0; i < coverage.size(); ++i)
+        coverage[i] = atlas.Pages[0][i * 4];
+
+    for (unsigned int c = 0; c < TEXT_GLYPHS; c++) {
+        const AtlasRect& rect = atlas.Rects[c];
+        this->Characters[c].UVMin = glm::vec2(rect.X, rect.Y) / static_cast<float>(pageSize);
+        this->Characters[c].UVMax = glm::vec2(rect.X + rect.Width, rect.Y + rect.Height) / static_cast<float>(pageSize);
+    }
+    this->capHeight = static_cast<float>(this->Characters['H'].Bearing.y);
+
+    //Upload the atlas (rows of single bytes, so disable byte-alignment restriction)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    this->Atlas.Internal_Format = GL_RED;
+    this->Atlas.Image_Format = GL_RED;
+    this->Atlas.Wrap_U = GL_CLAMP_TO_EDGE;
+    this->Atlas.Wrap_V = GL_CLAMP_TO_EDGE;
+    this->Atlas.Generate(pageSize, pageSize, coverage.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
-void TextRenderer::RenderText(std::string text, float x, float y, float scale, glm::vec3 color) 
+void TextRenderer::Begin()
 {
-    //Activate the corresponding render state
-    this->TextShader.Use();
-    this->TextShader.SetVector3f("textColor", color);
+    this->vertices.clear();
+    this->DrawCalls = 0;
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+void TextRenderer::SubmitText(std::string_view text, float x, float y, float scale, glm::vec3 color)
+{
+    //Laid out into scratch space that keeps its capacity between calls
+    this->scratch.clear();
+    this->Layout(text, x, y, scale, color, this->scratch);
+    this->Append(this->scratch.data(), this->scratch.size());
+}
 
-    //Iterate through all characters
-    std::string::const_iterator c;
+void TextRenderer::SubmitText(TextObject& text)
+{
+    //Lay the text out again only if it changed since last time
+    if (text.generation != this->generation)
+    {
+        text.vertices.clear();
+        this->Layout(text.text, text.x, text.y, text.scale, text.color, text.vertices);
+        text.generation = this->generation;
+    }
+    this->Append(text.vertices.data(), text.vertices.size());
+}
 
-    for (c = text.begin(); c != text.end(); c++)
+void TextRenderer::Layout(std::string_view text, float x, float y, float scale, glm::vec3 color, std::vector<TextVertex>& out) const
+{
+    for (char c : text)
     {
-        Character ch = Characters[*c];
+        const Character& ch = this->Characters[static_cast<unsigned char>(c) % TEXT_GLYPHS];
 
-        float xPos = x + ch.Bearing.x * scale;
-        float yPos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
+        //Blank glyphs (spaces) only move the cursor
+        if (ch.Size.x > 0 && ch.Size.y > 0)
+        {
+            float xPos = x + ch.Bearing.x * scale;
+            float yPos = y + (this->capHeight - ch.Bearing.y) * scale;
 
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
+            float w = ch.Size.x * scale;
+            float h = ch.Size.y * scale;
 
-        //Update VBO for each character
-        float vertices[6][4] = {
-            { xPos,     yPos + h,   0.0f, 1.0f },
-            { xPos + w, yPos,       1.0f, 0.0f },
-            { xPos,     yPos,       0.0f, 0.0f },
+            // top left, top right, bottom right, bottom left
+            out.push_back({ glm::vec2(xPos,     yPos),     glm::vec2(ch.UVMin.x, ch.UVMin.y), color });
+            out.push_back({ glm::vec2(xPos + w, yPos),     glm::vec2(ch.UVMax.x, ch.UVMin.y), color });
+            out.push_back({ glm::vec2(xPos + w, yPos + h), glm::vec2(ch.UVMax.x, ch.UVMax.y), color });
+            out.push_back({ glm::vec2(xPos,     yPos + h), glm::vec2(ch.UVMin.x, ch.UVMax.y), color });
+        }
 
-            { xPos,     yPos + h,   0.0f, 1.0f },
-            { xPos + w, yPos + h,   1.0f, 1.0f },
-            { xPos + w, yPos,       1.0f, 0.0f }
-        };
+        // now advance cursors for next glyph
+        x += ch.Advance * scale;
+    }
+}
 
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
+void TextRenderer::Append(const TextVertex* glyphVertices, size_t count)
+{
+    while (count > 0)
+    {
+        if (this->vertices.size() == MAX_BATCH_GLYPHS * 4)
+            this->Flush();
 
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        size_t copied = std::min(count, MAX_BATCH_GLYPHS * 4 - this->vertices.size());
+        this->vertices.insert(this->vertices.end(), glyphVertices, glyphVertices + copied);
+        glyphVertices += copied;
+        count -= copied;
+    }
+}
 
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+void TextRenderer::Flush()
+{
+    if (this->vertices.empty())
+        return;
 
-        // now advance cursors for next glyph
-        x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
-    }
+    //Activate the corresponding render state
+    this->TextShader.Use();
+    GLState::ActiveTexture(0);
+    this->Atlas.Bind();
+
+    //Orphan the old storage so the driver doesn't wait for the previous draw to finish with it
+    GLState::BindArrayBuffer(this->VBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_GLYPHS * 4 * sizeof(TextVertex), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, this->vertices.size() * sizeof(TextVertex), this->vertices.data());
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // render all queued glyphs (bindings stay, the state cache skips rebinding them)
+    GLState::BindVertexArray(this->VAO);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(this->vertices.size() / 4 * 6), GL_UNSIGNED_INT, (void*)0);
+
+    this->vertices.clear();
+    ++this->DrawCalls;
+}
+
+void TextRenderer::End()
+{
+    this->Flush();
+}
+
+void TextRenderer::Draw()
+{
+    this->Flush();
+}
+
+void TextRenderer::RenderText(std::string_view text, float x, float y, float scale, glm::vec3 color) 
+{
+    this->SubmitText(text, x, y, scale, color);
+    this->Flush();
 }
\ No newline at end of file
@@ -1,44 +1,144 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
-#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "texture.hpp"
 #include "shader.hpp"
+#include "render_queue.hpp"
+
+//Glyphs loaded from a font (the ASCII range)
+const unsigned int TEXT_GLYPHS = 128;
+
+//Most glyphs in one draw call; a fuller batch is drawn and started over
+const unsigned int MAX_BATCH_GLYPHS = 1024;
 
 //Character state info
 struct Character {
-	unsigned int TextureID; //ID handle of glyph texture
+	glm::vec2 UVMin, UVMax; //Region of the glyph in the atlas
 	glm::ivec2 Size;		//Size of Glyph
 	glm::ivec2 Bearing;		//offset from baseline to left/top of glyph
-	unsigned int Advance;	//horizontal offset to advance to next glyph
+	float Advance;			//horizontal offset to advance to next glyph (pixels)
+};
+
+//Vertex of a batched glyph (screen space)
+struct TextVertex {
+	glm::vec2 Position;
+	glm::vec2 TexCoords;
+	glm::vec3 Color;
+};
+
+class TextRenderer;
+
+//A string whose glyph layout is kept between frames: it's only laid out
+//again when its text, position, scale or color (or the font) change, so
+//submitting an unchanged one just copies its vertices into the batch.
+class TextObject
+{
+public:
+	//Constructor
+	TextObject(float x = 0.0f, float y = 0.0f, float scale = 1.0f, glm::vec3 color = glm::vec3(1.0f));
+
+	//Set the text (nothing happens if it's the same)
+	void SetText(std::string_view text);
+
+	//Set the text to a prefix followed by a number, formatted without allocating
+	void SetText(std::string_view prefix, long long number);
+
+	//Set where and how the text is drawn
+	void SetPosition(float x, float y);
+	void SetScale(float scale);
+	void SetColor(glm::vec3 color);
+
+	const std::string& GetText() const { return this->text; }
+
+private:
+	friend class TextRenderer;
+
+	std::string text;
+	float x, y, scale;
+	glm::vec3 color;
+
+	//Cached layout and the font generation it was made with (0 = out of date)
+	std::vector<TextVertex> vertices;
+	unsigned int generation;
 };
 
 //A renderer class for rendering text displayed by a font using the FreeType library.
-class TextRenderer
+//All glyphs live in one atlas texture, so any number of strings can share a batch:
+//SubmitText only lays a string out, and everything queued is drawn with a single
+//call by Flush/End (or once the batch is full).
+class TextRenderer : public Drawable
 {
 public:
-	//Hold list of pre-compiled characters
-	std::map<char, Character> Characters;
+	//Pre-compiled characters, indexed by character code
+	Character Characters[TEXT_GLYPHS];
+
+	//Texture holding every glyph (red channel only)
+	Texture2D Atlas;
 
 	//Shader used for Text Rendering
 	Shader TextShader;
 
+	//Draw calls issued since the last Begin
+	unsigned int DrawCalls;
+
 	//Constructor
-	TextRenderer(unsigned int width, unsigned int height);
+	TextRenderer();
+
+	//Destructor
+	~TextRenderer();
 
 	//Pre-compiles a list of characters from a font sheet
 	void Load(std::string font, unsigned int fontSize);
 
-	//Renders a string of text using the precompiled list of characters
-	void RenderText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
+	//Start a new batch (resets the draw call count)
+	void Begin();
+
+	//Queue a string of text
+	void SubmitText(std::string_view text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
+
+	//Queue a text object (laid out again only if it changed)
+	void SubmitText(TextObject& text);
+
+	//Draw all queued text
+	void Flush();
+
+	//Finish the batch (draws what's left)
+	void End();
+
+	//Draw all queued text (Flush, for the render queue)
+	void Draw() override;
+
+	//Renders a string of text right away
+	void RenderText(std::string_view text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
 
 private:
 	//Render state
-	unsigned int VAO, VBO;
+	unsigned int VAO, VBO, EBO;
+
+	//Current batch
+	std::vector<TextVertex> vertices;
+
+	//Layout of the last plain string submitted
+	std::vector<TextVertex> scratch;
+
+	//Bumped by every Load, so text objects laid out with an older font are redone
+	unsigned int generation;
+
+	//Top of a capital letter above the baseline ('H' bearing); lines are aligned to it
+	float capHeight;
+
+	//Append the glyph quads of a string to a vertex list
+	void Layout(std::string_view text, float x, float y, float scale, glm::vec3 color, std::vector<TextVertex>& out) const;
+
+	//Append laid out glyph quads to the batch, drawing whenever it's full
+	void Append(const TextVertex* glyphVertices, size_t count);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "collision_simd.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX__)
+#define COLLISION_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLISION_SSE2
+#include <emmintrin.h>
+#endif
+
+void PackAABBs(const glm::vec2* positions, const glm::vec2* sizes, const unsigned int* indices, unsigned int count, std::vector<AABBPack>& packs)
+{
+    packs.resize((count + AABB_PACK_SIZE - 1) / AABB_PACK_SIZE);
+
+    for (unsigned int i = 0; i < packs.size() * AABB_PACK_SIZE; ++i)
+    {
+        AABBPack& pack = packs[i / AABB_PACK_SIZE];
+        unsigned int lane = i % AABB_PACK_SIZE;
+
+        if (i < count)
+        {
+            glm::vec2 min = positions[indices[i]];
+            glm::vec2 max = min + sizes[indices[i]];
+            pack.MinX[lane] = min.x;
+            pack.MinY[lane] = min.y;
+            pack.MaxX[lane] = max.x;
+            pack.MaxY[lane] = max.y;
+        }
+        else
+        {
+            // empty box: clamping to it lands infinitely far away
+            pack.MinX[lane] = pack.MinY[lane] = FLT_MAX;
+            pack.MaxX[lane] = pack.MaxY[lane] = -FLT_MAX;
+        }
+    }
+}
+
+unsigned int CircleVsAABB8Scalar(glm::vec2 center, float radius, const AABBPack& pack, CircleHits* hits)
+{
+    unsigned int mask = 0;
+
+    for (unsigned int lane = 0; lane < AABB_PACK_SIZE; ++lane)
+    {
+        // vector from the closest point on the box to the circle's center
+        float closestX = center.x > pack.MinX[lane] ? center.x : pack.MinX[lane];
+        float closestY = center.y > pack.MinY[lane] ? center.y : pack.MinY[lane];
+        float dx = center.x - (closestX < pack.MaxX[lane] ? closestX : pack.MaxX[lane]);
+        float dy = center.y - (closestY < pack.MaxY[lane] ? closestY : pack.MaxY[lane]);
+        float distance2 = dx * dx + dy * dy;
+
+        if (distance2 < radius * radius)
+        {
+            mask |= 1u << lane;
+            if (hits)
+            {
+                float distance = std::sqrt(distance2);
+                float inverse = distance > 0.0f ? 1.0f / distance : 0.0f;
+                hits->NormalX[lane] = dx * inverse;
+                hits->NormalY[lane] = dy * inverse;
+                hits->Depth[lane] = radius - distance;
+            }
+        }
+    }
+    return mask;
+}
+
+#if defined(COLLISION_AVX)
+
+unsigned int CircleVsAABB8(glm::vec2 center, float radius, const AABBPack& pack, CircleHits* hits)
+{
+    __m256 cx = _mm256_set1_ps(center.x);
+    __m256 cy = _mm256_set1_ps(center.y);
+    __m256 dx = _mm256_sub_ps(cx, _mm256_min_ps(_mm256_max_ps(cx, _mm256_load_ps(pack.MinX)), _mm256_load_ps(pack.MaxX)));
+    __m256 dy = _mm256_sub_ps(cy, _mm256_min_ps(_mm256_max_ps(cy, _mm256_load_ps(pack.MinY)), _mm256_load_ps(pack.MaxY)));
+    __m256 distance2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+    unsigned int mask = _mm256_movemask_ps(_mm256_cmp_ps(distance2, _mm256_set1_ps(radius * radius), _CMP_LT_OQ));
+
+    if (hits && mask)
+    {
+        __m256 distance = _mm256_sqrt_ps(distance2);
+        __m256 inverse = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), distance),
+            _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GT_OQ));
+        _mm256_store_ps(hits->NormalX, _mm256_mul_ps(dx, inverse));
+        _mm256_store_ps(hits->NormalY, _mm256_mul_ps(dy, inverse));
+        _mm256_store_ps(hits->Depth, _mm256_sub_ps(_mm256_set1_ps(radius), distance));
+    }
+    return mask;
+}
+
+#elif defined(COLLISION_SSE2)
+
+unsigned int CircleVsAABB8(glm::vec2 center, float radius, const AABBPack& pack, CircleHits* hits)
+{
+    __m128 cx = _mm_set1_ps(center.x);
+    __m128 cy = _mm_set1_ps(center.y);
+    __m128 r2 = _mm_set1_ps(radius * radius);
+    unsigned int mask = 0;
+
+    // two halves of 4 lanes
+    for (unsigned int half = 0; half < AABB_PACK_SIZE; half += 4)
+    {
+        __m128 dx = _mm_sub_ps(cx, _mm_min_ps(_mm_max_ps(cx, _mm_load_ps(pack.MinX + half)), _mm_load_ps(pack.MaxX + half)));
+        __m128 dy = _mm_sub_ps(cy, _mm_min_ps(_mm_max_ps(cy, _mm_load_ps(pack.MinY + half)), _mm_load_ps(pack.MaxY + half)));
+        __m128 distance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+        unsigned int halfMask = _mm_movemask_ps(_mm_cmplt_ps(distance2, r2));
+        mask |= halfMask << half;
+
+        if (hits && halfMask)
+        {
+            __m128 distance = _mm_sqrt_ps(distance2);
+            __m128 inverse = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), distance), _mm_cmpgt_ps(distance, _mm_setzero_ps()));
+            _mm_store_ps(hits->NormalX + half, _mm_mul_ps(dx, inverse));
+            _mm_store_ps(hits->NormalY + half, _mm_mul_ps(dy, inverse));
+            _mm_store_ps(hits->Depth + half, _mm_sub_ps(_mm_set1_ps(radius), distance));
+        }
+    }
+    return mask;
+}
+
+#else
+
+unsigned int CircleVsAABB8(glm::vec2 center, float radius, const AABBPack& pack, CircleHits* hits)
+{
+    return CircleVsAABB8Scalar(center, radius, pack, hits);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef COLLISION_SIMD_H
+#define COLLISION_SIMD_H
+
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <glm/glm.hpp>
+
+//Batch circle vs. AABB overlap tests, 8 boxes per call.
+//Uses AVX when the build targets it (/arch:AVX2, -mavx2), SSE2 on any
+//x64 build and plain scalar code everywhere else; every path returns
+//exactly the same results.
+
+//Number of boxes in one pack
+const unsigned int AABB_PACK_SIZE = 8;
+
+//8 AABBs in structure-of-arrays form. Unused lanes hold an empty box
+//(min > max) that never overlaps anything.
+struct AABBPack {
+	alignas(32) float MinX[AABB_PACK_SIZE];
+	alignas(32) float MinY[AABB_PACK_SIZE];
+	alignas(32) float MaxX[AABB_PACK_SIZE];
+	alignas(32) float MaxY[AABB_PACK_SIZE];
+};
+
+//Penetration data of one circle against a pack, valid for lanes set in the hit mask
+struct CircleHits {
+	alignas(32) float NormalX[AABB_PACK_SIZE]; //Direction pushing the circle out of the box (zero if its center is inside)
+	alignas(32) float NormalY[AABB_PACK_SIZE];
+	alignas(32) float Depth[AABB_PACK_SIZE];   //How far the circle reaches into the box
+};
+
+//Pack the boxes (position, size) of the given indices, in order, 8 per pack
+void PackAABBs(const glm::vec2* positions, const glm::vec2* sizes, const unsigned int* indices, unsigned int count, std::vector<AABBPack>& packs);
+
+//Test a circle against the 8 boxes of a pack. Returns the hit mask (bit i = circle overlaps box i,
+//touching doesn't count) and fills in the penetration data when hits is given.
+unsigned int CircleVsAABB8(glm::vec2 center, float radius, const AABBPack& pack, CircleHits* hits = nullptr);
+
+//Portable reference implementation of CircleVsAABB8
+unsigned int CircleVsAABB8Scalar(glm::vec2 center, float radius, const AABBPack& pack, CircleHits* hits = nullptr);
+
+//Index of the lowest set bit of a non-zero mask
+inline unsigned int LowestBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long bit;
+	_BitScanForward(&bit, mask);
+	return bit;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+#endif
@@ -0,0 +1,35 @@
+#include "frame_uniforms.hpp"
+
+#include <cstring>
+
+FrameUniforms::FrameUniforms()
+	: Data(), uploaded(), valid(false)
+{
+	static_assert(sizeof(FrameData) == 80, "FrameData has to match the std140 layout of the Frame block");
+
+	glGenBuffers(1, &this->UBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	//The binding point keeps the buffer for good
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, this->UBO);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+	glDeleteBuffers(1, &this->UBO);
+}
+
+void FrameUniforms::Upload()
+{
+	if (this->valid && std::memcmp(&this->Data, &this->uploaded, sizeof(FrameData)) == 0)
+		return;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &this->Data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	this->uploaded = this->Data;
+	this->valid = true;
+}
\ No newline at end of file
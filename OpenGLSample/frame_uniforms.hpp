@@ -0,0 +1,43 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+//Binding point of the shaders' "Frame" uniform block
+const unsigned int FRAME_UNIFORM_BINDING = 0;
+
+//CPU side of the std140 "Frame" block every shader that needs frame-global
+//data declares; the member offsets have to match the block's
+struct FrameData {
+	glm::mat4 Projection; //offset 0
+	float Time;			  //offset 64
+	float Padding[3];	  //std140 rounds the block up to 80 bytes
+};
+
+//FrameUniforms owns the uniform buffer behind the "Frame" block. Shaders
+//get their block wired to FRAME_UNIFORM_BINDING when they're linked, so the
+//data is uploaded once per frame for all of them, however many there are.
+class FrameUniforms {
+
+public:
+	//Values for the frame being rendered
+	FrameData Data;
+
+	//Constructor/Destructor (needs a current OpenGL context)
+	FrameUniforms();
+	~FrameUniforms();
+
+	//Upload Data if it changed since the last upload
+	void Upload();
+
+private:
+	//Render state
+	unsigned int UBO;
+
+	//What the buffer holds
+	FrameData uploaded;
+	bool valid;
+};
+
+#endif
\ No newline at end of file
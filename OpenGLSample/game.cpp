@@ -1,101 +1,24 @@
 #include "game.hpp"
-#include "resource_manager.hpp"
-#include "sprite_renderer.hpp"
-#include "game_object.hpp"
-#include "Ball.hpp"
-#include "ParticleGenerator.hpp"
-#include "PostProcessor.hpp"
 
-#include <sstream>
-
-//Audio
-#include <irrKlang.h>
-#include "TextRenderer.hpp"
-using namespace irrklang;
-
-// Game-related State data
-SpriteRenderer* Renderer;
-GameObject* Player;
-BallObject* Ball;
-ParticleGenerator* Particles;
-PostProcessor* Effects;
-
-//Text
-TextRenderer* Text;
-
-//Audio
-ISoundEngine* SoundEngine = createIrrKlangDevice();
-
-//Effects
-float ShakeTime = 0.0f;
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
 
 Game::Game(unsigned int width, unsigned int height)
-    : State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), Level(0), Lives(3)
+    : State(GAME_MENU), Keys(), KeysProcessed(), Width(width), Height(height), Tick(0), Level(0), Lives(3),
+      Player(nullptr), BallContacts(false), Confuse(false), Chaos(false), Shake(false), ShakeTime(0.0f)
 {
     //Player->Lives = Lives;
 }
 
 Game::~Game()
 {
-    delete Renderer;
     delete Player;
-    delete Ball;
-    delete Particles;
-    delete Effects;
-    delete Text;
-    SoundEngine->drop();
 }
 
 void Game::Init()
 {
-
-    //Audio
-    SoundEngine->play2D("audio/breakout.mp3", true);
-
-    //Text
-    Text = new TextRenderer(this->Width, this->Height);
-    Text->Load("fonts/ocraext.TTF", 24);
-
-    // load shaders
-    ResourceManager::LoadShader("shaders/spriteVertex.glsl", "shaders/spriteFragment.glsl", nullptr, "sprite");
-    ResourceManager::LoadShader("shaders/particleVertex.glsl", "shaders/particleFragment.glsl", nullptr, "particle");
-    ResourceManager::LoadShader("shaders/postProcessingVertex.glsl", "shaders/postProcessingFragment.glsl", nullptr, "post");
-
-    // configure shaders
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(this->Width),
-        static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
-    ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
-    ResourceManager::GetShader("sprite").SetMatrix4("projection", projection);
-    ResourceManager::GetShader("particle").Use().SetInteger("sprite", 0);
-    ResourceManager::GetShader("particle").SetMatrix4("projection", projection);
-
-    // load textures
-    ResourceManager::LoadTexture("textures/background.jpg", false, "background");
-    ResourceManager::LoadTexture("textures/ball.png", true, "ball");
-    ResourceManager::LoadTexture("textures/block.png", false, "block");
-    ResourceManager::LoadTexture("textures/block_solid.png", false, "block_solid");
-    ResourceManager::LoadTexture("textures/paddle.png", true, "paddle");
-    ResourceManager::LoadTexture("textures/particle.png", true, "particle");
-
-    //Powerups
-    ResourceManager::LoadTexture("textures/powerup_speedUp.png", true, "speed-up");
-    ResourceManager::LoadTexture("textures/powerup_speedDown.png", true, "speed-down");
-    ResourceManager::LoadTexture("textures/powerup_sticky.png", true, "sticky");
-    ResourceManager::LoadTexture("textures/powerup_passthrough.png", true, "pass-through");
-    ResourceManager::LoadTexture("textures/powerup_increase.png", true, "pad-increase");
-    ResourceManager::LoadTexture("textures/powerup_decrease.png", true, "pad-decrease");
-    ResourceManager::LoadTexture("textures/powerup_confuse.png", true, "confuse");
-    ResourceManager::LoadTexture("textures/powerup_chaos.png", true, "chaos");
-    ResourceManager::LoadTexture("textures/powerup_lifeUp.png", true, "life-up");
-
-    // set render-specific controls
-    Shader shader = ResourceManager::GetShader("sprite");
-    Renderer = new SpriteRenderer(shader);
-    shader = ResourceManager::GetShader("particle");
-    Particles = new ParticleGenerator(shader, ResourceManager::GetTexture("particle"), 500);
-    shader = ResourceManager::GetShader("post");
-    Effects = new PostProcessor(shader, this->Width, this->Height);
-
     // load levels
     GameLevel one; one.Load("levels/one.lvl", this->Width, this->Height / 2);
     GameLevel two; two.Load("levels/two.lvl", this->Width, this->Height / 2);
@@ -111,27 +34,31 @@ void Game::Init()
 
     // configure game objects
     glm::vec2 playerPos = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
-    Player = new GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetTexture("paddle"));
+    Player = new GameObject(playerPos, PLAYER_SIZE);
     Player->Lives = Lives;
     glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - INITIAL_BALL_RADIUS, -INITIAL_BALL_RADIUS * 2.0f);
     
-    Ball = new BallObject(ballPos, INITIAL_BALL_RADIUS, INITIAL_BALL_VELOCITY, ResourceManager::GetTexture("ball"));
-    Ball->Color = glm::vec3(1.0f, 0.0f, 0.0f);
+    this->Balls.push_back(BallObject(ballPos, INITIAL_BALL_RADIUS, INITIAL_BALL_VELOCITY));
+    this->Balls[0].Color = glm::vec3(1.0f, 0.0f, 0.0f);
 }
 
-void Game::Update(float dt)
+void Game::AddListener(GameListener* listener)
 {
-    // update objects
-    Ball->Move(dt, this->Width);
+    this->Listeners.push_back(listener);
+}
 
-    // check for collisions
-    this->DoCollisions();
+void Game::Update(float dt)
+{
+    // move the balls and check for collisions
+    this->DoCollisions(dt);
 
-    // update particles
-    Particles->Update(dt, *Ball, 2, glm::vec2(Ball->Radius / 2.0f));
+    // balls that reached the bottom edge are lost
+    this->Balls.erase(std::remove_if(this->Balls.begin(), this->Balls.end(),
+        [this](const BallObject& ball) { return ball.Position.y >= this->Height; }
+    ), this->Balls.end());
 
     // check loss
-    if (Ball->Position.y >= this->Height) // did ball reach bottom edge?
+    if (this->Balls.empty()) // did the last ball reach bottom edge?
     {
         --Player->Lives;
 
@@ -145,11 +72,11 @@ void Game::Update(float dt)
     }
 
     //Update Effects
-    if (ShakeTime > 0.0f) {
-        ShakeTime -= dt;
+    if (this->ShakeTime > 0.0f) {
+        this->ShakeTime -= dt;
 
-        if (ShakeTime <= 0.0f) {
-            Effects->Shake = false;
+        if (this->ShakeTime <= 0.0f) {
+            this->Shake = false;
         }
     }
 
@@ -158,7 +85,7 @@ void Game::Update(float dt)
     {
         this->ResetLevel();
         this->ResetPlayer();
-        Effects->Chaos = true;
+        this->Chaos = true;
         this->State = GAME_WIN;
     }
 
@@ -166,6 +93,20 @@ void Game::Update(float dt)
     UpdatePowerUps(dt);
 }
 
+void Game::Step(float dt)
+{
+    // remember the state rendering interpolates from
+    Player->PreviousPosition = Player->Position;
+    for (BallObject& ball : this->Balls)
+        ball.PreviousPosition = ball.Position;
+    for (PowerUp& powerUp : this->PowerUps)
+        powerUp.PreviousPosition = powerUp.Position;
+
+    this->ProcessInput(dt);
+    this->Update(dt);
+    ++this->Tick;
+}
+
 void Game::ProcessInput(float dt)
 {
     if (this->State == GAME_ACTIVE)
@@ -173,48 +114,58 @@ void Game::ProcessInput(float dt)
         float velocity = PLAYER_VELOCITY * dt;
 
         // move player paddle
-        if (this->Keys[GLFW_KEY_A])
+        if (this->Keys[KEY_A])
         {
             if (Player->Position.x >= 0.0f)
             {
                 Player->Position.x -= velocity;
-                if (Ball->Stuck)
-                    Ball->Position.x -= velocity;
+                for (BallObject& ball : this->Balls)
+                    if (ball.Stuck)
+                        ball.Position.x -= velocity;
             }
         }
-        if (this->Keys[GLFW_KEY_D])
+        if (this->Keys[KEY_D])
         {
             if (Player->Position.x <= this->Width - Player->Size.x)
             {
                 Player->Position.x += velocity;
-                if (Ball->Stuck)
-                    Ball->Position.x += velocity;
+                for (BallObject& ball : this->Balls)
+                    if (ball.Stuck)
+                        ball.Position.x += velocity;
             }
         }
-        if (this->Keys[GLFW_KEY_SPACE])
-            Ball->Stuck = false;
+        if (this->Keys[KEY_SPACE])
+            for (BallObject& ball : this->Balls)
+                ball.Stuck = false;
+
+        //Stress mode: launch another batch of balls
+        if (this->Keys[KEY_B] && !this->KeysProcessed[KEY_B])
+        {
+            this->LaunchBalls(STRESS_BALLS);
+            this->KeysProcessed[KEY_B] = true;
+        }
     }
 
     //Game Menu Input
     if (this->State == GAME_MENU) 
     {
         //Enter a level
-        if (this->Keys[GLFW_KEY_ENTER] && !this->KeysProcessed[GLFW_KEY_ENTER])
+        if (this->Keys[KEY_ENTER] && !this->KeysProcessed[KEY_ENTER])
         {
             this->State = GAME_ACTIVE;
-            this->KeysProcessed[GLFW_KEY_ENTER] = true;
+            this->KeysProcessed[KEY_ENTER] = true;
         }
 
         //Navigate Levels
-        if (this->Keys[GLFW_KEY_W] && !this->KeysProcessed[GLFW_KEY_W])
+        if (this->Keys[KEY_W] && !this->KeysProcessed[KEY_W])
         {
             this->Level = (this->Level + 1) % this->Levels.size();
-            this->KeysProcessed[GLFW_KEY_W] = true;
+            this->KeysProcessed[KEY_W] = true;
         }
 
-        if (this->Keys[GLFW_KEY_S] && !this->KeysProcessed[GLFW_KEY_S])
+        if (this->Keys[KEY_S] && !this->KeysProcessed[KEY_S])
         {
-            this->KeysProcessed[GLFW_KEY_S] = true;
+            this->KeysProcessed[KEY_S] = true;
             if (this->Level > 0)
                 --this->Level;
             else
@@ -225,69 +176,15 @@ void Game::ProcessInput(float dt)
     //Game Win Input
     if (this->State == GAME_WIN) 
     {
-        if (this->Keys[GLFW_KEY_ENTER])
+        if (this->Keys[KEY_ENTER])
         {
-            this->KeysProcessed[GLFW_KEY_ENTER] = true;
-            Effects->Chaos = false;
+            this->KeysProcessed[KEY_ENTER] = true;
+            this->Chaos = false;
             this->State = GAME_MENU;
         }
     }
 }
 
-void Game::Render()
-{
-    if (this->State == GAME_ACTIVE || this->State == GAME_MENU || this->State == GAME_WIN)
-    {
-        //Post Processor start
-        Effects->BeginRender();
-
-        // draw background
-        Texture2D background = ResourceManager::GetTexture("background");
-        Renderer->DrawSprite(background, glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f);
-
-        // draw level
-        this->Levels[this->Level].Draw(*Renderer);
-
-        // draw player
-        Player->Draw(*Renderer);
-
-        // draw particles	
-        Particles->Draw();
-
-        //Draw Powerups
-        for (PowerUp& powerUp : this->PowerUps) {
-            if (!powerUp.Destroyed) {
-                powerUp.Draw(*Renderer);
-            }
-        }
-
-        // draw ball
-        Ball->Draw(*Renderer);
-
-        //Post Processor end
-        Effects->EndRender();
-        Effects->Render(glfwGetTime());
-
-        //Draw UI (No Post)
-        std::stringstream ss; ss << Player->Lives;
-        Text->RenderText("Lives:" + ss.str(), 5.0f, 5.0f, 1.0f);
-    }
-
-    //Game Menu only text
-    if (this->State == GAME_MENU)
-    {
-        Text->RenderText("Press ENTER to start", 250.0f, Height / 2, 1.0f);
-        Text->RenderText("Press W or S to select level", 245.0f, Height / 2 + 20.0f, 0.75f);
-    }
-
-    //Game Win render
-    if (this->State == GAME_WIN) {
-        Text->RenderText("You WON!!!", 320.0, Height / 2 - 20.0, 1.0, glm::vec3(0.0, 1.0, 0.0));
-        Text->RenderText("Press ENTER to retry or ESC to quit", 130.0, Height / 2, 1.0, glm::vec3(1.0, 1.0, 0.0));
-    }
-}
-
-
 void Game::ResetLevel()
 {
     //Remove all powerups on screen
@@ -315,118 +212,294 @@ void Game::ResetPlayer()
 {
     // reset player/ball stats
     Player->Size = PLAYER_SIZE;
-    Player->Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
-    Ball->Reset(Player->Position + glm::vec2(PLAYER_SIZE.x / 2.0f - INITIAL_BALL_RADIUS, -(INITIAL_BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);
+    Player->Position = Player->PreviousPosition = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+    glm::vec2 ballPos = Player->Position + glm::vec2(PLAYER_SIZE.x / 2.0f - INITIAL_BALL_RADIUS, -(INITIAL_BALL_RADIUS * 2.0f));
+    this->Balls.resize(1, BallObject(ballPos, INITIAL_BALL_RADIUS, INITIAL_BALL_VELOCITY));
+    BallObject& ball = this->Balls[0];
+    ball.Reset(ballPos, INITIAL_BALL_VELOCITY);
 
     //disable all active powerups
-    Effects->Chaos = Effects->Confuse = false;
-    Ball->PassThrough = Ball->Sticky = false;
+    this->Chaos = this->Confuse = false;
+    ball.PassThrough = ball.Sticky = false;
     Player->Color = glm::vec3(1.0f);
-    Ball->Color = glm::vec3(1.0f, 0.0f, 0.0f);
+    ball.Color = glm::vec3(1.0f, 0.0f, 0.0f);
 }
 
 //Prototypes
 bool CheckCollision(GameObject& one, GameObject& two);
-Collision CheckCollision(BallObject& one, GameObject& two);
-Direction VectorDirection(glm::vec2 closest);
-bool ShouldSpawn(unsigned int chance);
-void ActivatePowerUp(PowerUp& powerUp);
+bool SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 move, glm::vec2 boxMin, glm::vec2 boxMax, float& time, glm::vec2& normal);
+bool ShouldSpawn(Random& rng, unsigned int chance);
 bool IsOtherPowerUpActive(std::vector <PowerUp>& powerUps, std::string type);
 
 // collision detection
-void Game::DoCollisions()
+void Game::DoCollisions(float dt)
+{
+    // move the balls, resolving their contacts in the order they happen
+    this->MoveBalls(dt);
+    if (this->BallContacts)
+        this->CollideBalls();
+
+    //Powerup collisions
+    for (PowerUp& powerUp : this->PowerUps) {
+        if (!powerUp.Destroyed) {
+
+            //If the powerup isnt grabbed, destroy it
+            if (powerUp.Position.y > this->Height)
+                powerUp.Destroyed = true;
+
+            if (CheckCollision(*Player, powerUp)) {
+                //Collided with player, activate the powerup
+                this->ActivatePowerUp(powerUp);
+                powerUp.Destroyed = true;
+                powerUp.Activated = true;
+                for (GameListener* listener : this->Listeners)
+                    listener->OnPowerUpActivated(powerUp);
+            }
+        }
+    }
+}
+
+void Game::MoveBalls(float dt)
 {
-    for (GameObject& box : this->Levels[this->Level].Bricks)
+    GameLevel& level = this->Levels[this->Level];
+    unsigned int ballCount = static_cast<unsigned int>(this->Balls.size());
+    unsigned int taskCount = (ballCount + BALLS_PER_TASK - 1) / BALLS_PER_TASK;
+    if (this->ballTasks.size() < taskCount)
+        this->ballTasks.resize(taskCount);
+
+    // every task moves a block of balls against the level as it was at the start of the step
+    std::function<void(unsigned int)> moveBlock = [this, ballCount, dt](unsigned int t) {
+        BallTask& task = this->ballTasks[t];
+        task.Contacts.clear();
+        unsigned int end = glm::min((t + 1) * BALLS_PER_TASK, ballCount);
+        for (unsigned int i = t * BALLS_PER_TASK; i < end; ++i)
+            if (!this->Balls[i].Stuck)
+                this->MoveBall(i, dt, task);
+    };
+
+    if (taskCount > 1 && !this->workers)
+        this->workers.reset(new WorkerPool());
+    if (this->workers)
+        this->workers->Run(taskCount, moveBlock);
+    else
+        for (unsigned int t = 0; t < taskCount; ++t)
+            moveBlock(t);
+
+    // then apply their contacts in ball order
+    for (unsigned int t = 0; t < taskCount; ++t)
     {
-        if (!box.Destroyed)
+        for (const BallContact& contact : this->ballTasks[t].Contacts)
         {
-            Collision collision = CheckCollision(*Ball, box);
-            if (std::get<0>(collision)) // if collision is true
+            if (contact.Brick < 0)
             {
-                // destroy block if not solid
-                if (!box.IsSolid)
-                {
-                    SoundEngine->play2D("audio/bleep.mp3", false);
-                    box.Destroyed = true;
-                    this->SpawnPowerUps(box);
-                }
-                else
-                {
-                    //Block is solid, shake effect
-                    SoundEngine->play2D("audio/solid.wav", false);
-                    ShakeTime = 0.05f;
-                    Effects->Shake = true;
-                }
+                for (GameListener* listener : this->Listeners)
+                    listener->OnPaddleHit(*Player);
+                continue;
+            }
 
-                // collision resolution
-                Direction dir = std::get<1>(collision);
-                glm::vec2 diff_vector = std::get<2>(collision);
+            unsigned int brick = contact.Brick;
+            if (level.IsSolid(brick))
+            {
+                //Block is solid, shake effect
+                this->ShakeTime = 0.05f;
+                this->Shake = true;
+                for (GameListener* listener : this->Listeners)
+                    listener->OnSolidBrickHit(level, brick);
+            }
+            else if (!level.IsDestroyed(brick)) //An earlier ball may have taken it out this step
+            {
+                level.DestroyBrick(brick);
+                for (GameListener* listener : this->Listeners)
+                    listener->OnBrickDestroyed(level, brick);
+                this->SpawnPowerUps(level.BrickPositions[brick]);
+            }
+        }
+    }
+}
 
-                //If Passthrough is inactive (or box is solid) perform normal bounce off box collisions.
-                if (!(Ball->PassThrough && !box.IsSolid))
-                {
+void Game::MoveBall(unsigned int index, float dt, BallTask& task)
+{
+    BallObject& ball = this->Balls[index];
+    const GameLevel& level = this->Levels[this->Level];
+    float remaining = dt;
+    task.Destroyed.clear();
 
-                    if (dir == LEFT || dir == RIGHT) // horizontal collision
-                    {
-                        Ball->Velocity.x = -Ball->Velocity.x; // reverse horizontal velocity
-                        // relocate
-                        float penetration = Ball->Radius - std::abs(diff_vector.x);
-                        if (dir == LEFT)
-                            Ball->Position.x += penetration; // move ball right
-                        else
-                            Ball->Position.x -= penetration; // move ball left;
-                    }
-                    else // vertical collision
-                    {
-                        Ball->Velocity.y = -Ball->Velocity.y; // reverse vertical velocity
-                        // relocate
-                        float penetration = Ball->Radius - std::abs(diff_vector.y);
-                        if (dir == UP)
-                            Ball->Position.y -= penetration; // move ball up
-                        else
-                            Ball->Position.y += penetration; // move ball down
-                    }
+    for (unsigned int contact = 0; contact < MAX_BALL_CONTACTS && remaining > 0.0f; ++contact)
+    {
+        glm::vec2 move = ball.Velocity * remaining;
+        glm::vec2 center = ball.Position + ball.Radius;
+
+        // find the earliest contact along the move (as a fraction of it)
+        enum { NONE, WALL, BRICK, PADDLE } hit = NONE;
+        float hitTime = 1.0f;
+        glm::vec2 hitNormal(0.0f);
+        unsigned int hitBrick = 0;
+
+        // walls (left, right and top; the bottom edge is open)
+        if (move.x < 0.0f && ball.Position.x + move.x <= 0.0f) {
+            hit = WALL;
+            hitTime = glm::max(-ball.Position.x / move.x, 0.0f);
+            hitNormal = glm::vec2(1.0f, 0.0f);
+        }
+        else if (move.x > 0.0f && ball.Position.x + ball.Size.x + move.x >= this->Width) {
+            hit = WALL;
+            hitTime = glm::max((this->Width - ball.Size.x - ball.Position.x) / move.x, 0.0f);
+            hitNormal = glm::vec2(-1.0f, 0.0f);
+        }
+        if (move.y < 0.0f && ball.Position.y + move.y <= 0.0f) {
+            float time = glm::max(-ball.Position.y / move.y, 0.0f);
+            if (hit == NONE || time < hitTime) {
+                hit = WALL;
+                hitTime = time;
+                hitNormal = glm::vec2(0.0f, 1.0f);
+            }
+        }
+
+        // bricks the ball's path passes over
+        glm::vec2 sweptMin = glm::min(ball.Position, ball.Position + move);
+        glm::vec2 sweptMax = glm::max(ball.Position, ball.Position + move) + ball.Size;
+        level.QueryBricks(sweptMin, sweptMax, task.NearbyBricks);
+
+        // batch-test them against the circle bounding the whole swept path (the ball can only
+        // touch bricks it overlaps) and run the exact sweep on the survivors, in brick order
+        glm::vec2 boundCenter = center + move * 0.5f;
+        float boundRadius = ball.Radius + glm::length(move) * 0.5f + 0.01f;
+        PackAABBs(level.BrickPositions.data(), level.BrickSizes.data(), task.NearbyBricks.data(), static_cast<unsigned int>(task.NearbyBricks.size()), task.NearbyPacks);
+
+        for (unsigned int pack = 0; pack < task.NearbyPacks.size(); ++pack)
+        {
+            unsigned int mask = CircleVsAABB8(boundCenter, boundRadius, task.NearbyPacks[pack]);
+            for (; mask; mask &= mask - 1)
+            {
+                unsigned int brick = task.NearbyBricks[pack * AABB_PACK_SIZE + LowestBit(mask)];
+                float time;
+                glm::vec2 normal;
+                glm::vec2 boxMin = level.BrickPositions[brick];
+                if (!level.IsDestroyed(brick) && SweepCircleAABB(center, ball.Radius, move, boxMin, boxMin + level.BrickSizes[brick], time, normal) && time < hitTime &&
+                    std::find(task.Destroyed.begin(), task.Destroyed.end(), brick) == task.Destroyed.end())
+                {
+                    hit = BRICK;
+                    hitTime = time;
+                    hitNormal = normal;
+                    hitBrick = brick;
                 }
             }
         }
-    }
-    // check collisions for player pad (unless stuck)
-    Collision result = CheckCollision(*Ball, *Player);
-    if (!Ball->Stuck && std::get<0>(result))
-    {
-        SoundEngine->play2D("audio/bleep.wav", false);
 
-        // check where it hit the board, and change velocity based on where it hit the board
-        float centerBoard = Player->Position.x + Player->Size.x / 2.0f;
-        float distance = (Ball->Position.x + Ball->Radius) - centerBoard;
-        float percentage = distance / (Player->Size.x / 2.0f);
-        // then move accordingly
-        float strength = 2.0f;
-        glm::vec2 oldVelocity = Ball->Velocity;
-        Ball->Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
-        //Ball->Velocity.y = -Ball->Velocity.y;
-        Ball->Velocity = glm::normalize(Ball->Velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
-        // fix sticky paddle
-        Ball->Velocity.y = -1.0f * abs(Ball->Velocity.y);
+        // player paddle (only when the ball comes down onto it)
+        {
+            float time;
+            glm::vec2 normal;
+            if (ball.Velocity.y > 0.0f && SweepCircleAABB(center, ball.Radius, move, Player->Position, Player->Position + Player->Size, time, normal) && time < hitTime)
+            {
+                hit = PADDLE;
+                hitTime = time;
+                hitNormal = normal;
+            }
+        }
+
+        // advance to the contact (or the end of the step)
+        ball.Position += move * hitTime;
+        remaining *= 1.0f - hitTime;
+
+        if (hit == NONE)
+            break;
+
+        if (hit == WALL)
+        {
+            ball.Velocity = glm::reflect(ball.Velocity, hitNormal);
+        }
+        else if (hit == BRICK)
+        {
+            bool solid = level.IsSolid(hitBrick);
+            task.Contacts.push_back({ index, static_cast<int>(hitBrick) });
+
+            // a brick this ball destroys is gone for the rest of its move
+            if (!solid)
+                task.Destroyed.push_back(hitBrick);
 
-        //If sticky, stick the ball to the paddle
-        Ball->Stuck = Ball->Sticky;
+            //If Passthrough is inactive (or box is solid) bounce off the box, otherwise keep going through it.
+            if (!(ball.PassThrough && !solid))
+                ball.Velocity = glm::reflect(ball.Velocity, hitNormal);
+        }
+        else if (hit == PADDLE)
+        {
+            task.Contacts.push_back({ index, -1 });
+
+            // check where it hit the board, and change velocity based on where it hit the board
+            float centerBoard = Player->Position.x + Player->Size.x / 2.0f;
+            float distance = (ball.Position.x + ball.Radius) - centerBoard;
+            float percentage = distance / (Player->Size.x / 2.0f);
+            // then move accordingly
+            float strength = 2.0f;
+            glm::vec2 oldVelocity = ball.Velocity;
+            ball.Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
+            ball.Velocity = glm::normalize(ball.Velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
+            // fix sticky paddle
+            ball.Velocity.y = -1.0f * std::abs(ball.Velocity.y);
+
+            //If sticky, stick the ball to the paddle (for the rest of this step too)
+            ball.Stuck = ball.Sticky;
+            if (ball.Stuck)
+                break;
+        }
     }
+}
 
-    //Powerup collisions
-    for (PowerUp& powerUp : this->PowerUps) {
-        if (!powerUp.Destroyed) {
+void Game::CollideBalls()
+{
+    unsigned int count = static_cast<unsigned int>(this->Balls.size());
+    auto leftOf = [this](unsigned int a, unsigned int b) { return this->Balls[a].Position.x < this->Balls[b].Position.x; };
 
-            //If the powerup isnt grabbed, destroy it
-            if (powerUp.Position.y > this->Height)
-                powerUp.Destroyed = true;
+    // sort by left edge; balls barely move in a step, so last step's order is nearly
+    // sorted and insertion sort stays close to linear (unless balls came or went)
+    if (this->sweepOrder.size() != count)
+    {
+        this->sweepOrder.resize(count);
+        std::iota(this->sweepOrder.begin(), this->sweepOrder.end(), 0u);
+        std::sort(this->sweepOrder.begin(), this->sweepOrder.end(), leftOf);
+    }
+    else
+    {
+        for (unsigned int i = 1; i < count; ++i)
+        {
+            unsigned int current = this->sweepOrder[i], j = i;
+            for (; j > 0 && leftOf(current, this->sweepOrder[j - 1]); --j)
+                this->sweepOrder[j] = this->sweepOrder[j - 1];
+            this->sweepOrder[j] = current;
+        }
+    }
 
-            if (CheckCollision(*Player, powerUp)) {
-                //Collided with player, activate the powerup
-                SoundEngine->play2D("audio/powerup.wav", false);
-                ActivatePowerUp(powerUp);
-                powerUp.Destroyed = true;
-                powerUp.Activated = true;
+    // sweep: a ball can only touch the balls that start before its right edge
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        BallObject& one = this->Balls[this->sweepOrder[i]];
+
+        for (unsigned int j = i + 1; j < count; ++j)
+        {
+            BallObject& two = this->Balls[this->sweepOrder[j]];
+            if (two.Position.x > one.Position.x + one.Size.x)
+                break;
+            if (one.Stuck || two.Stuck)
+                continue;
+
+            glm::vec2 difference = (two.Position + two.Radius) - (one.Position + one.Radius);
+            float reach = one.Radius + two.Radius;
+            float distance2 = glm::dot(difference, difference);
+            if (distance2 >= reach * reach || distance2 == 0.0f)
+                continue;
+
+            // separate them, then swap their velocities along the contact normal (equal masses)
+            float distance = std::sqrt(distance2);
+            glm::vec2 normal = difference / distance;
+            one.Position -= normal * (reach - distance) * 0.5f;
+            two.Position += normal * (reach - distance) * 0.5f;
+
+            float approach = glm::dot(one.Velocity - two.Velocity, normal);
+            if (approach > 0.0f)
+            {
+                one.Velocity -= normal * approach;
+                two.Velocity += normal * approach;
             }
         }
     }
@@ -444,152 +517,203 @@ bool CheckCollision(GameObject& one, GameObject& two) // AABB - AABB collision
     return collisionX && collisionY;
 }
 
-Collision CheckCollision(BallObject& one, GameObject& two) // AABB - Circle collision
+// Moving circle - AABB collision (time of impact).
+// Returns true if the circle moving by 'move' touches the box while moving into it; 'time' is the
+// fraction of 'move' at first contact ([0, 1]) and 'normal' the box's surface normal at the contact.
+// A circle that already overlaps the box counts as touching at time 0.
+bool SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 move, glm::vec2 boxMin, glm::vec2 boxMax, float& time, glm::vec2& normal)
 {
-    // get center point circle first 
-    glm::vec2 center(one.Position + one.Radius);
-    // calculate AABB info (center, half-extents)
-    glm::vec2 aabb_half_extents(two.Size.x / 2.0f, two.Size.y / 2.0f);
-    glm::vec2 aabb_center(two.Position.x + aabb_half_extents.x, two.Position.y + aabb_half_extents.y);
-    // get difference vector between both centers
-    glm::vec2 difference = center - aabb_center;
-    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
-    // now that we know the clamped values, add this to AABB_center and we get the value of box closest to circle
-    glm::vec2 closest = aabb_center + clamped;
-    // now retrieve vector between center circle and closest point AABB and check if length < radius
-    difference = closest - center;
-
-    if (glm::length(difference) < one.Radius) // not <= since in that case a collision also occurs when object one exactly touches object two, which they are at the end of each collision resolution stage.
-        return std::make_tuple(true, VectorDirection(difference), difference);
-    else
-        return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
-}
+    // already overlapping? push out along the shortest way (closest point on the box)
+    glm::vec2 closest = glm::clamp(center, boxMin, boxMax);
+    glm::vec2 difference = center - closest;
+    float distance2 = glm::dot(difference, difference);
+    if (distance2 < radius * radius)
+    {
+        if (distance2 > 0.0f)
+            normal = difference / std::sqrt(distance2);
+        else if (glm::dot(move, move) > 0.0f)
+            normal = -glm::normalize(move); // center inside the box, send it back where it came from
+        else
+            return false;
+        time = 0.0f;
+        return glm::dot(move, normal) < 0.0f;
+    }
 
-// calculates which direction a vector is facing (N,E,S or W)
-Direction VectorDirection(glm::vec2 target)
-{
-    glm::vec2 compass[] = {
-        glm::vec2(0.0f, 1.0f),	// up
-        glm::vec2(1.0f, 0.0f),	// right
-        glm::vec2(0.0f, -1.0f),	// down
-        glm::vec2(-1.0f, 0.0f)	// left
-    };
-    float max = 0.0f;
-    unsigned int best_match = -1;
-    for (unsigned int i = 0; i < 4; i++)
+    // slab test of the circle's center against the box grown by the radius
+    glm::vec2 grownMin = boxMin - radius, grownMax = boxMax + radius;
+    float enter = -1.0f, exit = 2.0f;
+    int axis = -1;
+    for (int i = 0; i < 2; ++i)
     {
-        float dot_product = glm::dot(glm::normalize(target), compass[i]);
-        if (dot_product > max)
+        if (move[i] == 0.0f)
         {
-            max = dot_product;
-            best_match = i;
+            if (center[i] < grownMin[i] || center[i] > grownMax[i])
+                return false;
+            continue;
         }
-    }
-    return (Direction)best_match;
+        float t1 = (grownMin[i] - center[i]) / move[i];
+        float t2 = (grownMax[i] - center[i]) / move[i];
+        if (t1 > t2)
+            std::swap(t1, t2);
+        if (t1 > enter)
+        {
+            enter = t1;
+            axis = i;
+        }
+        exit = glm::min(exit, t2);
+        if (enter > exit)
+            return false;
+    }
+    if (enter > 1.0f || exit < 0.0f)
+        return false;
+
+    // entering through a face of the grown box?
+    glm::vec2 point = center + move * glm::max(enter, 0.0f);
+    bool outsideX = point.x < boxMin.x || point.x > boxMax.x;
+    bool outsideY = point.y < boxMin.y || point.y > boxMax.y;
+    if (!(outsideX && outsideY))
+    {
+        if (axis < 0 || enter < 0.0f)
+            return false;
+        normal = glm::vec2(0.0f);
+        normal[axis] = move[axis] > 0.0f ? -1.0f : 1.0f;
+        time = enter;
+        return true;
+    }
+
+    // otherwise it is in a corner region: hit the rounded corner (a circle of the ball's radius)
+    glm::vec2 corner(point.x < boxMin.x ? boxMin.x : boxMax.x, point.y < boxMin.y ? boxMin.y : boxMax.y);
+    glm::vec2 m = center - corner;
+    float a = glm::dot(move, move);
+    float b = glm::dot(m, move);
+    float c = glm::dot(m, m) - radius * radius;
+    float discriminant = b * b - a * c;
+    if (b >= 0.0f || discriminant < 0.0f)
+        return false;
+    float t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1.0f)
+        return false;
+    time = glm::max(t, 0.0f);
+    normal = glm::normalize(center + move * time - corner);
+    return true;
 }
 
 //Determines if Powerup should spawn
-bool ShouldSpawn(unsigned int chance) {
-    unsigned int random = rand() % chance;
+bool ShouldSpawn(Random& rng, unsigned int chance) {
+    unsigned int random = rng.NextUInt(chance);
     return random == 0;
 }
 
 //Spawn Powerups
-void Game::SpawnPowerUps(GameObject& block) {
+void Game::SpawnPowerUps(glm::vec2 position) {
 
     //Speed Up
-    if (ShouldSpawn(30)) //1 in 30 chance
+    if (ShouldSpawn(this->Rng, 30)) //1 in 30 chance
     {
         this->PowerUps.push_back(
-            PowerUp("speed-up", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position, ResourceManager::GetTexture("speed-up")));
+            PowerUp("speed-up", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, position));
     }
 
     //Speed Down
-    if (ShouldSpawn(50)) //1 in 50 chance
+    if (ShouldSpawn(this->Rng, 50)) //1 in 50 chance
     {
         this->PowerUps.push_back(
-            PowerUp("speed-down", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position, ResourceManager::GetTexture("speed-down")));
+            PowerUp("speed-down", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, position));
     }
 
     //Sticky
-    if (ShouldSpawn(60)) //1 in 60 chance
+    if (ShouldSpawn(this->Rng, 60)) //1 in 60 chance
     {
         this->PowerUps.push_back(
-            PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, block.Position, ResourceManager::GetTexture("sticky")));
+            PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, position));
     }
 
     //Pass-Through
-    if (ShouldSpawn(75)) //1 in 75 chance
+    if (ShouldSpawn(this->Rng, 75)) //1 in 75 chance
     {
         this->PowerUps.push_back(
-            PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, block.Position, ResourceManager::GetTexture("pass-through")));
+            PowerUp("pass-through", glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, position));
     }
 
     //pad-size-increase
-    if (ShouldSpawn(50)) //1 in 50 chance
+    if (ShouldSpawn(this->Rng, 50)) //1 in 50 chance
     {
         this->PowerUps.push_back(
-            PowerUp("pad-increase", glm::vec3(1.0f, 0.6f, 0.4f), 0.0f, block.Position, ResourceManager::GetTexture("pad-increase")));
+            PowerUp("pad-increase", glm::vec3(1.0f, 0.6f, 0.4f), 0.0f, position));
     }
     //pad-size-decrease
-    if (ShouldSpawn(40)) //1 in 40 chance
+    if (ShouldSpawn(this->Rng, 40)) //1 in 40 chance
     {
         this->PowerUps.push_back(
-            PowerUp("pad-decrease", glm::vec3(1.0f, 0.0f, 0.0f), 0.0f, block.Position, ResourceManager::GetTexture("pad-decrease")));
+            PowerUp("pad-decrease", glm::vec3(1.0f, 0.0f, 0.0f), 0.0f, position));
     }
 
     //Confuse
-    if (ShouldSpawn(30)) //1 in 30 chance
+    if (ShouldSpawn(this->Rng, 30)) //1 in 30 chance
     {
         this->PowerUps.push_back(
-            PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, block.Position, ResourceManager::GetTexture("confuse")));
+            PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, position));
     }
 
     //Chaos
-    if (ShouldSpawn(30)) //1 in 15 chance
+    if (ShouldSpawn(this->Rng, 30)) //1 in 15 chance
     {
         this->PowerUps.push_back(
-            PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, block.Position, ResourceManager::GetTexture("chaos")));
+            PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, position));
     }
 
     //Life Up
-    if (ShouldSpawn(100)) //1 in 100 chance
+    if (ShouldSpawn(this->Rng, 100)) //1 in 100 chance
+    {
+        this->PowerUps.push_back(
+            PowerUp("life-up", glm::vec3(1.0f, 0.5f, 0.5f), 0.0f, position));
+    }
+
+    //Multi-Ball
+    if (ShouldSpawn(this->Rng, 40)) //1 in 40 chance
     {
         this->PowerUps.push_back(
-            PowerUp("life-up", glm::vec3(1.0f, 0.5f, 0.5f), 0.0f, block.Position, ResourceManager::GetTexture("life-up")));
+            PowerUp("multi-ball", glm::vec3(0.4f, 0.8f, 1.0f), 0.0f, position));
     }
 }
 
-void ActivatePowerUp(PowerUp& powerUp) {
+void Game::ActivatePowerUp(PowerUp& powerUp) {
 
     //Speed Power Ups
     if (powerUp.Type == "speed-up")
     {
-        Ball->Velocity *= 1.2f;
+        for (BallObject& ball : this->Balls)
+            ball.Velocity *= 1.2f;
     }
     else if (powerUp.Type == "speed-down")
     {
         float halfInitialVelocity = INITIAL_BALL_VELOCITY.y / 2.0;
 
-        if (Ball->Velocity.y > halfInitialVelocity)
-            Ball->Velocity *= 0.8f;
-        else
+        for (BallObject& ball : this->Balls)
         {
-            Ball->Velocity.x = halfInitialVelocity;
-            Ball->Velocity.y = halfInitialVelocity;
+            if (ball.Velocity.y > halfInitialVelocity)
+                ball.Velocity *= 0.8f;
+            else
+            {
+                ball.Velocity.x = halfInitialVelocity;
+                ball.Velocity.y = halfInitialVelocity;
+            }
         }
     }
 
     //Sticky
     else if (powerUp.Type == "sticky") {
-        Ball->Sticky = true;
+        for (BallObject& ball : this->Balls)
+            ball.Sticky = true;
         Player->Color = glm::vec3(1.0f, 0.5f, 1.0f);
     }
 
     //Pass-Through
     else if (powerUp.Type == "pass-through") {
-        Ball->PassThrough = true;
-        Ball->Color = glm::vec3(1.0f, 0.5f, 0.5f);
+        for (BallObject& ball : this->Balls) {
+            ball.PassThrough = true;
+            ball.Color = glm::vec3(1.0f, 0.5f, 0.5f);
+        }
     }
 
     //Pad Size Power Ups
@@ -608,15 +732,15 @@ void ActivatePowerUp(PowerUp& powerUp) {
 
     //Confusion
     else if (powerUp.Type == "confuse") {
-        if (!Effects->Chaos) {
-            Effects->Confuse = true; //Only active if chaos is off
+        if (!this->Chaos) {
+            this->Confuse = true; //Only active if chaos is off
         }
     }
 
     //Chaos
     else if (powerUp.Type == "chaos") {
-        if (!Effects->Confuse) {
-            Effects->Chaos = true; //Only active if confusion is off
+        if (!this->Confuse) {
+            this->Chaos = true; //Only active if confusion is off
         }
     }
 
@@ -624,6 +748,49 @@ void ActivatePowerUp(PowerUp& powerUp) {
     else if (powerUp.Type == "life-up") {
         Player->Lives++;
     }
+
+    //Multi-Ball
+    else if (powerUp.Type == "multi-ball") {
+        this->SplitBalls();
+    }
+}
+
+void Game::SplitBalls()
+{
+    //Every moving ball gets two copies heading 30 degrees to either side of it
+    const float angle = glm::radians(30.0f);
+    const glm::mat2 rotations[] = {
+        glm::mat2(std::cos(angle), std::sin(angle), -std::sin(angle), std::cos(angle)),
+        glm::mat2(std::cos(angle), -std::sin(angle), std::sin(angle), std::cos(angle))
+    };
+
+    size_t count = this->Balls.size();
+    for (size_t i = 0; i < count && this->Balls.size() + 2 <= MAX_BALLS; ++i) {
+        if (this->Balls[i].Stuck)
+            continue;
+
+        for (const glm::mat2& rotation : rotations) {
+            BallObject ball = this->Balls[i];
+            ball.Velocity = rotation * ball.Velocity;
+            this->Balls.push_back(ball);
+        }
+    }
+}
+
+void Game::LaunchBalls(unsigned int count)
+{
+    //Same look and powerups as the first ball, launched from the paddle somewhere within 60 degrees of straight up
+    glm::vec2 position = Player->Position + glm::vec2(Player->Size.x / 2.0f - INITIAL_BALL_RADIUS, -(INITIAL_BALL_RADIUS * 2.0f));
+    float speed = glm::length(INITIAL_BALL_VELOCITY);
+
+    for (unsigned int i = 0; i < count && this->Balls.size() < MAX_BALLS; ++i) {
+        float angle = (this->Rng.NextFloat() - 0.5f) * glm::radians(120.0f);
+        BallObject ball = this->Balls[0];
+        ball.Position = ball.PreviousPosition = position;
+        ball.Velocity = speed * glm::vec2(std::sin(angle), -std::cos(angle));
+        ball.Stuck = false;
+        this->Balls.push_back(ball);
+    }
 }
 
 void Game::UpdatePowerUps(float dt)
@@ -645,7 +812,8 @@ void Game::UpdatePowerUps(float dt)
                 if (powerUp.Type == "sticky") {
                     if (!IsOtherPowerUpActive(this->PowerUps, "sticky")) {
                         //Only reset if no other powerup of type sticky is active
-                        Ball->Sticky = false;
+                        for (BallObject& ball : this->Balls)
+                            ball.Sticky = false;
                         Player->Color = glm::vec3(1.0f);
                     }
                 }
@@ -653,22 +821,24 @@ void Game::UpdatePowerUps(float dt)
                 {
                     if (!IsOtherPowerUpActive(this->PowerUps, "pass-through"))
                     {	// only reset if no other PowerUp of type pass-through is active
-                        Ball->PassThrough = false;
-                        Ball->Color = glm::vec3(1.0f, 0.0f, 0.0f);
+                        for (BallObject& ball : this->Balls) {
+                            ball.PassThrough = false;
+                            ball.Color = glm::vec3(1.0f, 0.0f, 0.0f);
+                        }
                     }
                 }
                 else if (powerUp.Type == "confuse")
                 {
                     if (!IsOtherPowerUpActive(this->PowerUps, "confuse"))
                     {	// only reset if no other PowerUp of type confuse is active
-                        Effects->Confuse = false;
+                        this->Confuse = false;
                     }
                 }
                 else if (powerUp.Type == "chaos")
                 {
                     if (!IsOtherPowerUpActive(this->PowerUps, "chaos"))
                     {	// only reset if no other PowerUp of type chaos is active
-                        Effects->Chaos = false;
+                        this->Chaos = false;
                     }
                 }
             }
@@ -1,12 +1,16 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include "game_level.hpp"
+#include "game_listener.hpp"
 #include "Ball.hpp"
+#include "collision_simd.hpp"
 #include "PowerUp.hpp"
+#include "random.hpp"
+#include "worker_pool.hpp"
 
 //Represents the current state of the Game
 enum GameState {
@@ -15,13 +19,18 @@ enum GameState {
 	GAME_WIN
 };
 
-//Direction Ball Collided on
-enum Direction {
-	UP, RIGHT, DOWN, LEFT
-};
+//Key codes read by ProcessInput. The values match GLFW's key tokens so the
+//window layer can write key events straight into Game::Keys.
+const unsigned int KEY_SPACE = 32;
+const unsigned int KEY_A = 65;
+const unsigned int KEY_B = 66;
+const unsigned int KEY_D = 68;
+const unsigned int KEY_S = 83;
+const unsigned int KEY_W = 87;
+const unsigned int KEY_ENTER = 257;
 
-//Collision Tuple
-typedef std::tuple<bool, Direction, glm::vec2> Collision; // <Collision? What Direction, difference vector center - closest point>
+//Size of Game::Keys/KeysProcessed; key codes are below this
+const unsigned int GAME_KEYS = 1024;
 
 //Initial size of the player's paddle
 const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
@@ -33,47 +42,131 @@ const float PLAYER_VELOCITY(500.0f);
 const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
 const float INITIAL_BALL_RADIUS = 12.5f;
 
+//Most contacts (bounces, pass-through bricks) a ball resolves within one step
+const unsigned int MAX_BALL_CONTACTS = 16;
+
+//Most balls in play at once (multi-ball powerup and stress mode)
+const unsigned int MAX_BALLS = 4096;
+
+//Balls launched from the paddle per press of the stress key (B)
+const unsigned int STRESS_BALLS = 256;
+
+//Balls moved by one worker task; a step with fewer balls stays on the calling thread
+const unsigned int BALLS_PER_TASK = 64;
+
+//Contact found while moving a ball, applied to the game once all balls have moved
+struct BallContact {
+	unsigned int Ball;
+	int Brick; //Brick index, -1 for the paddle
+};
+
 //Holds all game-related state and functionality.
 //Combines all game-related data in a single class
 //for easy access to each component.
+//Game is the pure simulation: it never touches OpenGL, GLFW or the
+//audio device. Rendering reads its state (GameRenderer) and audio
+//reacts to its events (GameListener), so it also runs headless.
 class Game
 {
 
 public:
 	//Game Data
 	GameState State;
-	bool Keys[1024];
-	bool KeysProcessed[1024];
+	bool Keys[GAME_KEYS];
+	bool KeysProcessed[GAME_KEYS];
 	unsigned int Width, Height;
 
+	//Number of simulation steps taken so far
+	uint64_t Tick;
+
 	std::vector<PowerUp> PowerUps;
 	std::vector<GameLevel> Levels;
 	unsigned int Level;
 
 	unsigned int Lives;
 
+	//Player paddle and the balls in play (never empty; a new life starts with one ball)
+	GameObject* Player;
+	std::vector<BallObject> Balls;
+
+	//Let balls bounce off each other (sweep and prune over the balls' x extents)
+	bool BallContacts;
+
+	//Effects requested by the simulation, applied by the renderer's post processor
+	bool Confuse, Chaos, Shake;
+	float ShakeTime;
+
+	//Random numbers of this session (powerup spawns); seed it for a reproducible game
+	Random Rng;
+
+	//Observers notified of simulation events
+	std::vector<GameListener*> Listeners;
+
 	//Constructor/Destructor
 	Game(unsigned int width, unsigned int height);
 	~Game();
 
-	//Initialize the game state (load all shaders/textures/levels)
+	//Initialize the game state (load all levels, create the paddle and ball)
 	void Init();
 
+	//Register an observer for simulation events (not owned by the game)
+	void AddListener(GameListener* listener);
+
 	//Game loop
 	void ProcessInput(float dt);
 	void Update(float dt);
-	void Render();
 
-	//Collisions
-	void DoCollisions();
+	//Advance the simulation by one fixed step (input + update).
+	//Remembers where everything was so rendering can interpolate.
+	void Step(float dt);
+
+	//Collisions: moves the balls over dt, then checks powerup pickups
+	void DoCollisions(float dt);
+
+	//Moves all balls over dt, spread over the worker threads when there are many.
+	//The level isn't changed while they move: each ball's brick and paddle contacts
+	//are collected and applied afterwards in ball order, so the outcome doesn't
+	//depend on the thread count.
+	void MoveBalls(float dt);
+
+	//Bounce touching balls off each other
+	void CollideBalls();
+
+	//Add balls launched from the paddle (stress mode)
+	void LaunchBalls(unsigned int count);
 
 	//Reset
 	void ResetLevel();
 	void ResetPlayer();
 
 	//PowerUps
-	void SpawnPowerUps(GameObject& block);
+	void SpawnPowerUps(glm::vec2 position);
+	void ActivatePowerUp(PowerUp& powerUp);
 	void UpdatePowerUps(float dt);
+
+private:
+	//Scratch and results of one worker task (reused every step to avoid allocations)
+	struct BallTask {
+		std::vector<unsigned int> NearbyBricks; //Bricks near the ball's path
+		std::vector<AABBPack> NearbyPacks;      //...and their packed boxes
+		std::vector<unsigned int> Destroyed;    //Bricks the current ball destroyed this step
+		std::vector<BallContact> Contacts;
+	};
+	std::vector<BallTask> ballTasks;
+
+	//Started on the first step with enough balls to share
+	std::unique_ptr<WorkerPool> workers;
+
+	//Balls sorted by left edge, kept between steps (nearly sorted already)
+	std::vector<unsigned int> sweepOrder;
+
+	//Moves one ball over dt with continuous collision detection: contacts with walls,
+	//bricks and the paddle are found by time of impact and resolved in the order they
+	//happen, so the ball can bounce several times within one step but never tunnels.
+	void MoveBall(unsigned int index, float dt, BallTask& task);
+
+	//Split every ball in play into three (multi-ball powerup)
+	void SplitBalls();
 };
 
 #endif
@@ -0,0 +1,38 @@
+#include "game_audio.hpp"
+
+using namespace irrklang;
+
+GameAudio::GameAudio()
+    : SoundEngine(createIrrKlangDevice())
+{
+}
+
+GameAudio::~GameAudio()
+{
+    SoundEngine->drop();
+}
+
+void GameAudio::PlayMusic()
+{
+    SoundEngine->play2D("audio/breakout.mp3", true);
+}
+
+void GameAudio::OnBrickDestroyed(const GameLevel& level, unsigned int brick)
+{
+    SoundEngine->play2D("audio/bleep.mp3", false);
+}
+
+void GameAudio::OnSolidBrickHit(const GameLevel& level, unsigned int brick)
+{
+    SoundEngine->play2D("audio/solid.wav", false);
+}
+
+void GameAudio::OnPaddleHit(const GameObject& paddle)
+{
+    SoundEngine->play2D("audio/bleep.wav", false);
+}
+
+void GameAudio::OnPowerUpActivated(const PowerUp& powerUp)
+{
+    SoundEngine->play2D("audio/powerup.wav", false);
+}
@@ -0,0 +1,32 @@
+#ifndef GAME_AUDIO_H
+#define GAME_AUDIO_H
+
+#include <irrKlang.h>
+
+#include "game_listener.hpp"
+
+//Plays the game's music and sound effects through irrKlang.
+//Attach to a Game with AddListener; the simulation itself never
+//talks to the audio device.
+class GameAudio : public GameListener
+{
+
+public:
+	//Constructor/Destructor (opens/closes the audio device)
+	GameAudio();
+	~GameAudio();
+
+	//Start the looping background music
+	void PlayMusic();
+
+	//Simulation events
+	void OnBrickDestroyed(const GameLevel& level, unsigned int brick) override;
+	void OnSolidBrickHit(const GameLevel& level, unsigned int brick) override;
+	void OnPaddleHit(const GameObject& paddle) override;
+	void OnPowerUpActivated(const PowerUp& powerUp) override;
+
+private:
+	irrklang::ISoundEngine* SoundEngine;
+};
+
+#endif
@@ -7,7 +7,14 @@ void GameLevel::Load(const char* file, unsigned int levelWidth, unsigned int lev
 {
 
 	//Clear old data
-	this->Bricks.clear();
+	this->BrickPositions.clear();
+	this->BrickSizes.clear();
+	this->BrickColors.clear();
+	this->SolidBits.clear();
+	this->DestroyedBits.clear();
+	this->DestructibleBricks = this->RemainingBricks = 0;
+	this->Grid.clear();
+	this->GridWidth = this->GridHeight = 0;
 
 	//Load from file
 	unsigned int tileCode;
@@ -35,27 +42,42 @@ void GameLevel::Load(const char* file, unsigned int levelWidth, unsigned int lev
 	}
 }
 
-//Draw each non-destroyed tile
-void GameLevel::Draw(SpriteRenderer& renderer) 
-{
-	for (GameObject& tile : this->Bricks) {
-		if (!tile.Destroyed) {
-			tile.Draw(renderer);
-		}
+void GameLevel::DestroyBrick(unsigned int brick) {
+
+	uint64_t& word = this->DestroyedBits[brick >> 6];
+	uint64_t bit = uint64_t(1) << (brick & 63);
+
+	//Only count each destructible brick once
+	if (!(word & bit)) {
+		word |= bit;
+		if (!this->IsSolid(brick))
+			--this->RemainingBricks;
 	}
 }
 
-bool GameLevel::IsCompleted() {
-
-	for (GameObject& tile : this->Bricks) {
-		if (!tile.IsSolid && !tile.Destroyed) {
-			//A non-solid tile still remains
-			return false;
+void GameLevel::QueryBricks(glm::vec2 min, glm::vec2 max, std::vector<unsigned int>& result) const
+{
+	result.clear();
+
+	//Nothing loaded or box outside of the level
+	if (this->Grid.empty() || max.x < 0.0f || max.y < 0.0f ||
+		min.x >= this->GridWidth * this->UnitWidth || min.y >= this->GridHeight * this->UnitHeight)
+		return;
+
+	//Overlapped cells, clamped to the grid (tiles touching the box edge count as overlapping)
+	unsigned int x0 = static_cast<unsigned int>(glm::max(min.x / this->UnitWidth, 0.0f));
+	unsigned int y0 = static_cast<unsigned int>(glm::max(min.y / this->UnitHeight, 0.0f));
+	unsigned int x1 = glm::min(static_cast<unsigned int>(max.x / this->UnitWidth), this->GridWidth - 1);
+	unsigned int y1 = glm::min(static_cast<unsigned int>(max.y / this->UnitHeight), this->GridHeight - 1);
+
+	//Row by row, which is the order Init added the bricks in
+	for (unsigned int y = y0; y <= y1; ++y) {
+		for (unsigned int x = x0; x <= x1; ++x) {
+			int index = this->Grid[y * this->GridWidth + x];
+			if (index >= 0)
+				result.push_back(index);
 		}
 	}
-
-	//All tiles destroyed
-	return true; 
 }
 
 void GameLevel::Init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight) 
@@ -65,39 +87,62 @@ void GameLevel::Init(std::vector<std::vector<unsigned int>> tileData, unsigned i
 	unsigned int width = tileData[0].size(); //We can index vector at [0] since this function is only called if height > 0
 	float unit_width = levelWidth / static_cast<float>(width), unit_height = levelHeight / height;
 
+	//Empty lookup grid matching the tile layout
+	this->GridWidth = width;
+	this->GridHeight = height;
+	this->UnitWidth = unit_width;
+	this->UnitHeight = unit_height;
+	this->Grid.assign(width * height, -1);
+
 	//Initialize level tiles based on tileData
 	for (unsigned int y = 0; y < height; ++y) {
 
 		for (unsigned int x = 0; x < width; ++x) {
 
+			glm::vec2 pos(unit_width * x, unit_height * y);
+			glm::vec2 size(unit_width, unit_height);
+
 			//Check block type from level data (2D level array)
 			if (tileData[y][x] == 1) //Solid
 			{
-				glm::vec2 pos(unit_width * x, unit_height * y);
-				glm::vec2 size(unit_width, unit_height);
-				GameObject obj(pos, size, ResourceManager::GetTexture("block_solid"), glm::vec3(0.8f, 0.8f, 0.7f));
-				obj.IsSolid = true;
-				this->Bricks.push_back(obj);
+				this->Grid[y * width + x] = this->BrickCount();
+				this->AddBrick(pos, size, 0, true);
 			}
 			else if (tileData[y][x] > 1) //non-solid; now determine its color based on level data
 			{
-				glm::vec3 color = glm::vec3(1.0f); //Original: white
-				if (tileData[y][x] == 2)
-					color = glm::vec3(0.2f, 0.6f, 1.0f);
-				else if (tileData[y][x] == 3)
-					color = glm::vec3(0.0f, 0.7f, 0.0f);
-				else if (tileData[y][x] == 4)
-					color = glm::vec3(0.8f, 0.8f, 0.4f);
-				else if (tileData[y][x] == 5)
-					color = glm::vec3(1.0f, 0.5f, 0.0f);
-
-				glm::vec2 pos(unit_width * x, unit_height * y);
-				glm::vec2 size(unit_width, unit_height);
-
-				this->Bricks.push_back(GameObject(pos, size, ResourceManager::GetTexture("block"), color));
+				uint8_t color = 5; //Original: white
+				if (tileData[y][x] <= 5)
+					color = tileData[y][x] - 1;
+
+				this->Grid[y * width + x] = this->BrickCount();
+				this->AddBrick(pos, size, color, false);
 			}
 
 		}
 
 	}
-}
\ No newline at end of file
+}
+
+void GameLevel::AddBrick(glm::vec2 pos, glm::vec2 size, uint8_t color, bool solid)
+{
+	unsigned int brick = this->BrickCount();
+
+	//Start a new word of flags every 64 bricks; unused bits are set so they count as
+	//solid and destroyed (never hit, never drawn, never needed to complete the level)
+	if ((brick & 63) == 0) {
+		this->SolidBits.push_back(~uint64_t(0));
+		this->DestroyedBits.push_back(~uint64_t(0));
+	}
+
+	uint64_t bit = uint64_t(1) << (brick & 63);
+	if (!solid) {
+		this->SolidBits.back() &= ~bit;
+		++this->DestructibleBricks;
+		++this->RemainingBricks;
+	}
+	this->DestroyedBits.back() &= ~bit;
+
+	this->BrickPositions.push_back(pos);
+	this->BrickSizes.push_back(size);
+	this->BrickColors.push_back(color);
+}
@@ -1,39 +1,75 @@
 #ifndef GAMELEVEL_H
 #define GAMELEVEL_H
 
+#include <cstdint>
 #include <vector>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include "game_object.hpp"
-#include "sprite_renderer.hpp"
-#include "resource_manager.hpp"
+//Brick colors, indexed by GameLevel::BrickColors
+const glm::vec3 BRICK_PALETTE[] = {
+	glm::vec3(0.8f, 0.8f, 0.7f), //Solid
+	glm::vec3(0.2f, 0.6f, 1.0f), //Tile code 2
+	glm::vec3(0.0f, 0.7f, 0.0f), //Tile code 3
+	glm::vec3(0.8f, 0.8f, 0.4f), //Tile code 4
+	glm::vec3(1.0f, 0.5f, 0.0f), //Tile code 5
+	glm::vec3(1.0f)				 //Any other code: white
+};
 
 //Game Level holds all Tiles as part of a Breakout level and
-//hosts functionality to Load/Render levels from the hard disk.
+//hosts functionality to Load levels from the hard disk.
+//Rendering is done by the GameRenderer.
+//Bricks are stored as a structure of arrays (brick i is element i of
+//every array, flags are bitsets) so the passes over them only stream
+//the few bytes they need instead of whole game objects.
 class GameLevel {
 
 public:
 	//level state
-	std::vector<GameObject> Bricks;
+	std::vector<glm::vec2> BrickPositions;
+	std::vector<glm::vec2> BrickSizes;
+	std::vector<uint8_t> BrickColors; //Index into BRICK_PALETTE
+	std::vector<uint64_t> SolidBits;
+	std::vector<uint64_t> DestroyedBits;
+
+	//Destructible (non-solid) bricks in the level and how many of them are still standing
+	unsigned int DestructibleBricks, RemainingBricks;
+
+	//Brick lookup grid: one cell per tile holding the tile's brick index (-1 if the tile is empty)
+	unsigned int GridWidth, GridHeight;
+	float UnitWidth, UnitHeight;
+	std::vector<int> Grid;
 
 	//Constructor
-	GameLevel() {};
+	GameLevel() : DestructibleBricks(0), RemainingBricks(0), GridWidth(0), GridHeight(0), UnitWidth(0.0f), UnitHeight(0.0f) {};
 
 	//Load level from file
 	void Load(const char* file, unsigned int levelWidth, unsigned int levelHeight);
 
-	//Render level
-	void Draw(SpriteRenderer& renderer);
-
 	//Check if the level is complete (all non-solid bricks are destroyed)
-	bool IsCompleted();
+	bool IsCompleted() const { return this->RemainingBricks == 0; }
+
+	//Fraction of the destructible bricks destroyed so far
+	float Progress() const { return this->DestructibleBricks ? 1.0f - this->RemainingBricks / static_cast<float>(this->DestructibleBricks) : 1.0f; }
+
+	//Brick accessors
+	unsigned int BrickCount() const { return static_cast<unsigned int>(this->BrickPositions.size()); }
+	bool IsSolid(unsigned int brick) const { return (this->SolidBits[brick >> 6] >> (brick & 63)) & 1; }
+	bool IsDestroyed(unsigned int brick) const { return (this->DestroyedBits[brick >> 6] >> (brick & 63)) & 1; }
+	void DestroyBrick(unsigned int brick);
+	glm::vec3 BrickColor(unsigned int brick) const { return BRICK_PALETTE[this->BrickColors[brick]]; }
+
+	//Collect the indices of all bricks whose tile overlaps the box [min, max], in brick order.
+	//Only the overlapped grid cells are visited, so the cost doesn't grow with the level size.
+	void QueryBricks(glm::vec2 min, glm::vec2 max, std::vector<unsigned int>& result) const;
 
 private:
 	//Instatiate the level
 	void Init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight);
 
+	//Append a brick to the arrays
+	void AddBrick(glm::vec2 pos, glm::vec2 size, uint8_t color, bool solid);
+
 };
 
-#endif
\ No newline at end of file
+#endif
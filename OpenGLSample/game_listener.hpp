@@ -0,0 +1,30 @@
+#ifndef GAME_LISTENER_H
+#define GAME_LISTENER_H
+
+#include "game_object.hpp"
+#include "game_level.hpp"
+#include "PowerUp.hpp"
+
+//Observer interface for anything that reacts to simulation events
+//(audio, particles, stats). Every callback defaults to a no-op so a
+//listener only overrides what it cares about. The simulation runs the
+//same with or without listeners attached.
+class GameListener {
+
+public:
+	virtual ~GameListener() {}
+
+	//A non-solid brick of the level was hit and destroyed
+	virtual void OnBrickDestroyed(const GameLevel& level, unsigned int brick) {}
+
+	//A solid brick of the level was hit
+	virtual void OnSolidBrickHit(const GameLevel& level, unsigned int brick) {}
+
+	//The ball bounced off the player's paddle
+	virtual void OnPaddleHit(const GameObject& paddle) {}
+
+	//The player's paddle picked up a powerup
+	virtual void OnPowerUpActivated(const PowerUp& powerUp) {}
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "game_renderer.hpp"
+#include "resource_manager.hpp"
+#include "gl_state.hpp"
+
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+
+GameRenderer::GameRenderer(unsigned int width, unsigned int height)
+    : Width(width), Height(height),
+      LivesText(5.0f, 5.0f, 1.0f),
+      MenuText(250.0f, height / 2.0f, 1.0f), LevelSelectText(245.0f, height / 2.0f + 20.0f, 0.75f),
+      WinText(320.0f, height / 2.0f - 20.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f)), RetryText(130.0f, height / 2.0f, 1.0f, glm::vec3(1.0f, 1.0f, 0.0f)),
+      Alpha(1.0f)
+{
+    //Text
+    Text = new TextRenderer();
+    Text->Load("fonts/ocraext.TTF", 24);
+    MenuText.SetText("Press ENTER to start");
+    LevelSelectText.SetText("Press W or S to select level");
+    WinText.SetText("You WON!!!");
+    RetryText.SetText("Press ENTER to retry or ESC to quit");
+
+    // load shaders
+    ResourceManager::LoadShader("shaders/spriteVertex.glsl", "shaders/spriteFragment.glsl", nullptr, "sprite");
+    ResourceManager::LoadShader("shaders/particleVertex.glsl", "shaders/particleFragment.glsl", nullptr, "particle");
+    ResourceManager::LoadTransformFeedbackShader("shaders/particleUpdateVertex.glsl", { "outPosition", "outVelocity", "outColor", "outLife" }, "particleUpdate");
+
+    // configure shaders
+    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(this->Width),
+        static_cast<float>(this->Height), 0.0f, -1.0f, 1.0f);
+    Frame = new FrameUniforms();
+    Frame->Data.Projection = projection;
+    ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
+    ResourceManager::GetShader("particle").Use().SetInteger("sprite", 0);
+
+    // load textures
+    ResourceManager::LoadTexture("textures/background.jpg", false, "background");
+    ResourceManager::LoadTexture("textures/particle.png", true, "particle");
+
+    // the sprites share one atlas so the batch never breaks between them
+    // (powerup texture names match PowerUp::Type)
+    ResourceManager::LoadAtlas({
+        { "textures/ball.png", "ball" },
+        { "textures/block.png", "block" },
+        { "textures/block_solid.png", "block_solid" },
+        { "textures/paddle.png", "paddle" },
+        { "textures/powerup_speedUp.png", "speed-up" },
+        { "textures/powerup_speedDown.png", "speed-down" },
+        { "textures/powerup_sticky.png", "sticky" },
+        { "textures/powerup_passthrough.png", "pass-through" },
+        { "textures/powerup_increase.png", "pad-increase" },
+        { "textures/powerup_decrease.png", "pad-decrease" },
+        { "textures/powerup_confuse.png", "confuse" },
+        { "textures/powerup_chaos.png", "chaos" },
+        { "textures/powerup_lifeUp.png", "life-up" }
+    });
+    ResourceManager::AliasTexture("multi-ball", "ball"); // no dedicated artwork yet
+
+    // set render-specific controls
+    Shader shader = ResourceManager::GetShader("sprite");
+    Renderer = new SpriteRenderer(shader);
+    shader = ResourceManager::GetShader("particle");
+    Particles = new ParticleSystem(shader, ResourceManager::GetShader("particleUpdate"), ResourceManager::GetTexture("particle"));
+    Effects = new PostProcessor(this->Width, this->Height);
+    Cache = new LevelCache(this->Width, this->Height);
+    Queue = new RenderQueue(Renderer, ResourceManager::GetShader("sprite").ID);
+}
+
+GameRenderer::~GameRenderer()
+{
+    delete Renderer;
+    delete Particles;
+    delete Effects;
+    delete Text;
+    delete Cache;
+    delete Queue;
+    delete Frame;
+    GLState::Invalidate(); // the deleted objects may have been bound
+}
+
+void GameRenderer::Update(const Game& game, float dt)
+{
+    // a frame's GL work starts here
+    GLState::ResetCounters();
+
+    // update particles
+    Particles->Update(game, dt);
+}
+
+void GameRenderer::Render(const Game& game, double time, float alpha)
+{
+    this->Alpha = alpha;
+    Queue->Begin();
+
+    //Frame-global shader data (one upload for every program). The effects only use time through
+    //sin/cos of whole multiples of it, so wrapping it to one 2*pi period keeps float precision
+    //however long the game has been running
+    Frame->Data.Time = static_cast<float>(std::fmod(time, 2.0 * glm::pi<double>()));
+    Frame->Upload();
+
+    if (game.State == GAME_ACTIVE || game.State == GAME_MENU || game.State == GAME_WIN)
+    {
+        // redraw whatever changed in the background and level since the last frame
+        Cache->Update(*Renderer, game.Levels[game.Level], ResourceManager::GetTexture("background"),
+            ResourceManager::GetTexture("block"), ResourceManager::GetTexture("block_solid"));
+
+        //Post Processor start (bypassed while no effect is on, else drawn with that effect set's shader)
+        Effects->ActiveEffects = (game.Confuse ? EFFECT_CONFUSE : 0) | (game.Chaos ? EFFECT_CHAOS : 0) | (game.Shake ? EFFECT_SHAKE : 0);
+        Effects->BeginRender();
+        Renderer->Begin();
+
+        // draw background and level (one quad)
+        Queue->Submit(LAYER_WORLD, BLEND_ALPHA, Cache->Texture, glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height));
+
+        // draw player
+        this->DrawObject(LAYER_PLAYER, *game.Player, ResourceManager::GetTexture("paddle"));
+
+        // draw particles (additive blending gives them a 'glow' effect)
+        Queue->Submit(LAYER_PARTICLES, BLEND_ADDITIVE, ResourceManager::GetShader("particle").ID, ResourceManager::GetTexture("particle").ID, Particles);
+
+        //Draw Powerups
+        for (const PowerUp& powerUp : game.PowerUps) {
+            if (!powerUp.Destroyed)
+                this->DrawObject(LAYER_OBJECTS, powerUp, ResourceManager::GetTexture(powerUp.Type));
+        }
+
+        // draw balls
+        Texture2D ball = ResourceManager::GetTexture("ball");
+        for (const BallObject& object : game.Balls)
+            this->DrawObject(LAYER_OBJECTS, object, ball);
+
+        // draw the scene in sorted order
+        Queue->Execute();
+        Renderer->End();
+
+        //Post Processor end
+        Effects->EndRender();
+        Effects->Render();
+    }
+
+    //Draw UI (No Post), all text in one batch
+    Text->Begin();
+    if (game.State == GAME_ACTIVE || game.State == GAME_MENU || game.State == GAME_WIN)
+    {
+        LivesText.SetText("Lives:", game.Player->Lives);
+        Text->SubmitText(LivesText);
+    }
+
+    //Game Menu only text
+    if (game.State == GAME_MENU)
+    {
+        Text->SubmitText(MenuText);
+        Text->SubmitText(LevelSelectText);
+    }
+
+    //Game Win render
+    if (game.State == GAME_WIN) {
+        Text->SubmitText(WinText);
+        Text->SubmitText(RetryText);
+    }
+    Queue->Submit(LAYER_UI, BLEND_ALPHA, Text->TextShader.ID, Text->Atlas.ID, Text);
+    Queue->Execute();
+}
+
+void GameRenderer::DrawObject(RenderLayer layer, const GameObject& object, const Texture2D& sprite)
+{
+    glm::vec2 position = glm::mix(object.PreviousPosition, object.Position, this->Alpha);
+    Queue->Submit(layer, BLEND_ALPHA, sprite, position, object.Size, object.Rotation, object.Color);
+}
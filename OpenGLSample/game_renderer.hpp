@@ -0,0 +1,68 @@
+#ifndef GAME_RENDERER_H
+#define GAME_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "game.hpp"
+#include "sprite_renderer.hpp"
+#include "particle_system.hpp"
+#include "level_cache.hpp"
+#include "render_queue.hpp"
+#include "frame_uniforms.hpp"
+#include "PostProcessor.hpp"
+#include "TextRenderer.hpp"
+
+//Draws a Game's state with OpenGL.
+//Owns every GL resource of the game (shaders, textures, renderers,
+//post processor) and only ever reads the simulation, so the Game
+//itself stays free of any rendering dependency.
+//Must be constructed after an OpenGL context is current.
+class GameRenderer
+{
+
+public:
+	unsigned int Width, Height;
+
+	//Particle effects; add to the Game as a listener for the brick and powerup bursts
+	ParticleSystem* Particles;
+
+	//Sorted draws of the frame; its counters profile the frame's state changes
+	RenderQueue* Queue;
+
+	//Constructor/Destructor (loads all shaders/textures)
+	GameRenderer(unsigned int width, unsigned int height);
+	~GameRenderer();
+
+	//Advance render-only state (particles of every ball) by dt
+	void Update(const Game& game, float dt);
+
+	//Render the game; time (seconds) drives the post processing effects and
+	//alpha [0, 1] is how far rendering is between the previous and current simulation step
+	void Render(const Game& game, double time, float alpha = 1.0f);
+
+private:
+	//Render state
+	SpriteRenderer* Renderer;
+	PostProcessor* Effects;
+	TextRenderer* Text;
+
+	//Background and bricks, kept rendered between frames
+	LevelCache* Cache;
+
+	//Projection and effect parameters shared by all shaders
+	FrameUniforms* Frame;
+
+	//HUD and menu text, laid out once and kept until it changes
+	TextObject LivesText;
+	TextObject MenuText, LevelSelectText;
+	TextObject WinText, RetryText;
+
+	//Interpolation factor of the frame being rendered
+	float Alpha;
+
+	//Queue a single game object with the given sprite at its interpolated position
+	void DrawObject(RenderLayer layer, const GameObject& object, const Texture2D& sprite);
+};
+
+#endif
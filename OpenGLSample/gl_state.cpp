@@ -0,0 +1,102 @@
+#include "gl_state.hpp"
+
+//Unknown state: no real binding ever matches it, so the next call is issued
+static const unsigned int UNKNOWN = ~0u;
+
+//Instantiate static variables
+unsigned int GLState::Issued = 0;
+unsigned int GLState::Skipped = 0;
+
+unsigned int GLState::program = UNKNOWN;
+unsigned int GLState::activeUnit = UNKNOWN;
+unsigned int GLState::textures[GL_STATE_TEXTURE_UNITS] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN,
+	UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+unsigned int GLState::vertexArray = UNKNOWN;
+unsigned int GLState::arrayBuffer = UNKNOWN;
+unsigned int GLState::readFramebuffer = UNKNOWN;
+unsigned int GLState::drawFramebuffer = UNKNOWN;
+GLenum GLState::blendSource = UNKNOWN;
+GLenum GLState::blendDestination = UNKNOWN;
+
+bool GLState::Changes(unsigned int& current, unsigned int value) {
+
+	if (current == value) {
+		++Skipped;
+		return false;
+	}
+	current = value;
+	++Issued;
+	return true;
+}
+
+void GLState::UseProgram(unsigned int program) {
+	if (Changes(GLState::program, program))
+		glUseProgram(program);
+}
+
+void GLState::ActiveTexture(unsigned int unit) {
+	if (Changes(activeUnit, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::BindTexture2D(unsigned int texture) {
+
+	//Only the first units are tracked
+	if (activeUnit >= GL_STATE_TEXTURE_UNITS) {
+		++Issued;
+		glBindTexture(GL_TEXTURE_2D, texture);
+		return;
+	}
+	if (Changes(textures[activeUnit], texture))
+		glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray) {
+	if (Changes(GLState::vertexArray, vertexArray))
+		glBindVertexArray(vertexArray);
+}
+
+void GLState::BindArrayBuffer(unsigned int buffer) {
+	if (Changes(arrayBuffer, buffer))
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+void GLState::BindFramebuffer(GLenum target, unsigned int framebuffer) {
+
+	//GL_FRAMEBUFFER sets both targets
+	bool read = target != GL_DRAW_FRAMEBUFFER && readFramebuffer != framebuffer;
+	bool draw = target != GL_READ_FRAMEBUFFER && drawFramebuffer != framebuffer;
+	if (!read && !draw) {
+		++Skipped;
+		return;
+	}
+	if (target != GL_DRAW_FRAMEBUFFER)
+		readFramebuffer = framebuffer;
+	if (target != GL_READ_FRAMEBUFFER)
+		drawFramebuffer = framebuffer;
+	++Issued;
+	glBindFramebuffer(target, framebuffer);
+}
+
+void GLState::BlendFunc(GLenum source, GLenum destination) {
+
+	if (source == blendSource && destination == blendDestination) {
+		++Skipped;
+		return;
+	}
+	blendSource = source;
+	blendDestination = destination;
+	++Issued;
+	glBlendFunc(source, destination);
+}
+
+void GLState::Invalidate() {
+	program = activeUnit = vertexArray = arrayBuffer = readFramebuffer = drawFramebuffer = UNKNOWN;
+	for (unsigned int& texture : textures)
+		texture = UNKNOWN;
+	blendSource = blendDestination = UNKNOWN;
+}
+
+void GLState::ResetCounters() {
+	Issued = Skipped = 0;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+//Texture units whose 2D binding is tracked
+const unsigned int GL_STATE_TEXTURE_UNITS = 16;
+
+//A static state cache in front of the OpenGL binding calls. It remembers
+//the current program, texture unit, 2D textures, vertex array, array
+//buffer, framebuffers and blend function, and skips calls that wouldn't
+//change anything. Shader::Use, Texture2D::Bind and the renderers all go
+//through it, so it only stays right as long as nothing binds behind its
+//back; call Invalidate after raw GL calls or deleting bound objects.
+//All functions/state are static and no public constructor defined.
+class GLState {
+
+public:
+	//Calls made since the last ResetCounters: passed on to GL, and skipped as redundant
+	static unsigned int Issued, Skipped;
+
+	//Bind calls
+	static void UseProgram(unsigned int program);
+	static void ActiveTexture(unsigned int unit); //unit index, not GL_TEXTUREi
+	static void BindTexture2D(unsigned int texture);
+	static void BindVertexArray(unsigned int vertexArray);
+	static void BindArrayBuffer(unsigned int buffer);
+	static void BindFramebuffer(GLenum target, unsigned int framebuffer); //GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER
+	static void BlendFunc(GLenum source, GLenum destination);
+
+	//Forget everything, so the next call of each kind is issued
+	static void Invalidate();
+
+	//Start counting a new frame
+	static void ResetCounters();
+
+private:
+	//private constructor, this is static
+	GLState();
+
+	//Tracked state (~0 while unknown)
+	static unsigned int program, activeUnit, textures[GL_STATE_TEXTURE_UNITS];
+	static unsigned int vertexArray, arrayBuffer, readFramebuffer, drawFramebuffer;
+	static GLenum blendSource, blendDestination;
+
+	//Count a call and tell whether it has to be issued
+	static bool Changes(unsigned int& current, unsigned int value);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "level_cache.hpp"
+#include "gl_state.hpp"
+
+#include <cmath>
+#include <iostream>
+
+LevelCache::LevelCache(unsigned int width, unsigned int height)
+	: Texture(), Width(width), Height(height), FullRedraw(false), DirtyBricks(0), level(nullptr), brickCount(0)
+{
+	//Screen sized color texture to render the layer into
+	this->Texture.Wrap_U = GL_CLAMP_TO_EDGE;
+	this->Texture.Wrap_V = GL_CLAMP_TO_EDGE;
+	this->Texture.Generate(width, height, NULL);
+
+	//Rows are stored bottom up, sprites are drawn top down
+	this->Texture.UVMin = glm::vec2(0.0f, 1.0f);
+	this->Texture.UVMax = glm::vec2(1.0f, 0.0f);
+
+	glGenFramebuffers(1, &this->FBO);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->Texture.ID, 0);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::LEVELCACHE: Failed to initialize FBO" << std::endl;
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+LevelCache::~LevelCache()
+{
+	glDeleteFramebuffers(1, &this->FBO);
+	glDeleteTextures(1, &this->Texture.ID);
+}
+
+void LevelCache::Invalidate()
+{
+	this->level = nullptr;
+}
+
+void LevelCache::Update(SpriteRenderer& renderer, const GameLevel& level, const Texture2D& background, const Texture2D& block, const Texture2D& solidBlock)
+{
+	this->FullRedraw = &level != this->level || level.BrickCount() != this->brickCount;
+	this->DirtyBricks = 0;
+
+	//Bricks whose flag flipped since the cache was drawn
+	if (!this->FullRedraw) {
+		bool changed = false;
+		for (size_t word = 0; word < this->destroyedBits.size() && !changed; ++word)
+			changed = this->destroyedBits[word] != level.DestroyedBits[word];
+		if (!changed)
+			return;
+	}
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+	renderer.Begin();
+
+	if (this->FullRedraw) {
+		//Everything: the background, then each standing brick (solid ones first, one batch per texture)
+		renderer.Submit(background, glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f);
+		for (bool solid : { true, false })
+			for (unsigned int brick = 0; brick < level.BrickCount(); ++brick)
+				if (level.IsSolid(brick) == solid)
+					this->SubmitBrick(renderer, level, brick, block, solidBlock);
+		renderer.Flush();
+	}
+	else {
+		//Only the changed bricks' rectangles: background and whatever bricks reach into them
+		glEnable(GL_SCISSOR_TEST);
+		for (size_t word = 0; word < this->destroyedBits.size(); ++word) {
+			uint64_t changed = this->destroyedBits[word] ^ level.DestroyedBits[word];
+			for (unsigned int bit = 0; changed; ++bit, changed >>= 1) {
+				if (!(changed & 1))
+					continue;
+				unsigned int brick = static_cast<unsigned int>(word * 64 + bit);
+
+				//Whole pixels covering the brick (the scissor box has its origin at the bottom left)
+				glm::vec2 min = glm::floor(level.BrickPositions[brick]);
+				glm::vec2 max = glm::ceil(level.BrickPositions[brick] + level.BrickSizes[brick]);
+				glScissor(static_cast<GLint>(min.x), static_cast<GLint>(this->Height - max.y),
+					static_cast<GLsizei>(max.x - min.x), static_cast<GLsizei>(max.y - min.y));
+
+				renderer.Submit(background, glm::vec2(0.0f, 0.0f), glm::vec2(this->Width, this->Height), 0.0f);
+				level.QueryBricks(min, max, this->nearbyBricks);
+				for (unsigned int nearby : this->nearbyBricks)
+					this->SubmitBrick(renderer, level, nearby, block, solidBlock);
+				renderer.Flush();
+				++this->DirtyBricks;
+			}
+		}
+		glDisable(GL_SCISSOR_TEST);
+	}
+
+	renderer.End();
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	//Remember what's drawn now
+	this->level = &level;
+	this->brickCount = level.BrickCount();
+	this->destroyedBits = level.DestroyedBits;
+}
+
+void LevelCache::SubmitBrick(SpriteRenderer& renderer, const GameLevel& level, unsigned int brick, const Texture2D& block, const Texture2D& solidBlock) const
+{
+	if (!level.IsDestroyed(brick))
+		renderer.Submit(level.IsSolid(brick) ? solidBlock : block, level.BrickPositions[brick], level.BrickSizes[brick], 0.0f, level.BrickColor(brick));
+}
\ No newline at end of file
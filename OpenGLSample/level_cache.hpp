@@ -0,0 +1,58 @@
+#ifndef LEVEL_CACHE_H
+#define LEVEL_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "game_level.hpp"
+#include "sprite_renderer.hpp"
+#include "texture.hpp"
+
+//LevelCache keeps the static part of the scene (background and bricks)
+//rendered in an offscreen texture, so a frame draws it as one quad no
+//matter how many bricks there are. It remembers which bricks it drew and
+//only redraws the rectangles of the bricks whose destroyed flag changed
+//since; switching to another level redraws everything.
+class LevelCache {
+
+public:
+	//The cached layer; its UVs are flipped so it can be drawn like any sprite
+	Texture2D Texture;
+
+	unsigned int Width, Height;
+
+	//Work done by the last Update: whole layer redrawn, and bricks redrawn on their own
+	bool FullRedraw;
+	unsigned int DirtyBricks;
+
+	//Constructor/Destructor (needs a current OpenGL context)
+	LevelCache(unsigned int width, unsigned int height);
+	~LevelCache();
+
+	//Bring the cache up to date with the level, drawing with the renderer.
+	//Binds its own framebuffer, so call it outside of any other offscreen pass.
+	void Update(SpriteRenderer& renderer, const GameLevel& level, const Texture2D& background, const Texture2D& block, const Texture2D& solidBlock);
+
+	//Redraw everything on the next Update
+	void Invalidate();
+
+private:
+	//Render state
+	unsigned int FBO;
+
+	//What the cache currently shows
+	const GameLevel* level;
+	unsigned int brickCount;
+	std::vector<uint64_t> destroyedBits;
+
+	//Scratch list of bricks overlapping a dirty rectangle
+	std::vector<unsigned int> nearbyBricks;
+
+	//Queue a brick if it's still standing
+	void SubmitBrick(SpriteRenderer& renderer, const GameLevel& level, unsigned int brick, const Texture2D& block, const Texture2D& solidBlock) const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "particle_pool.hpp"
+
+ParticlePool::ParticlePool(unsigned int capacity, float fadeRate)
+    : Positions(capacity), Velocities(capacity), Colors(capacity), Lives(capacity), Count(0), FadeRate(fadeRate),
+      Spawned(0), Dropped(0), Overflows(0), overflowed(false)
+{
+}
+
+bool ParticlePool::Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life)
+{
+    if (this->Count == this->Capacity())
+    {
+        ++this->Dropped;
+        this->overflowed = true;
+        return false;
+    }
+
+    unsigned int i = this->Count++;
+    this->Positions[i] = position;
+    this->Velocities[i] = velocity;
+    this->Colors[i] = color;
+    this->Lives[i] = life;
+    ++this->Spawned;
+    return true;
+}
+
+void ParticlePool::Update(float dt)
+{
+    if (this->overflowed)
+        ++this->Overflows;
+    this->overflowed = false;
+
+    // one tight loop per field over the live range only
+    unsigned int count = this->Count;
+    float* lives = this->Lives.data();
+    glm::vec2* positions = this->Positions.data();
+    const glm::vec2* velocities = this->Velocities.data();
+    glm::vec4* colors = this->Colors.data();
+    float fade = dt * this->FadeRate;
+
+    for (unsigned int i = 0; i < count; ++i)
+        lives[i] -= dt;
+    for (unsigned int i = 0; i < count; ++i)
+        positions[i] -= velocities[i] * dt;
+    for (unsigned int i = 0; i < count; ++i)
+        colors[i].a -= fade;
+
+    // remove the dead: the last live particle takes the dead one's place
+    for (unsigned int i = 0; i < count;)
+    {
+        if (lives[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
+        --count;
+        positions[i] = positions[count];
+        this->Velocities[i] = velocities[count];
+        colors[i] = colors[count];
+        lives[i] = lives[count];
+    }
+    this->Count = count;
+}
@@ -0,0 +1,42 @@
+#ifndef PARTICLE_POOL_H
+#define PARTICLE_POOL_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Fixed-capacity pool of particles in structure-of-arrays form.
+// Live particles are kept dense at the front of every array: spawning
+// appends behind the last one and a dying particle is replaced by the
+// last one, so both are O(1), no dead particle is ever visited and the
+// per-field update loops vectorize. Particle order is not preserved.
+// A spawn into a full pool is dropped (and counted), never overwrites.
+class ParticlePool
+{
+public:
+    // particle state, particle i is element i of every array; [0, Count) are alive
+    std::vector<glm::vec2> Positions, Velocities;
+    std::vector<glm::vec4> Colors;
+    std::vector<float>     Lives;
+    unsigned int Count;
+    // how fast (alpha per second) particles fade out
+    float FadeRate;
+    // statistics: spawned particles, spawns dropped because the pool was full,
+    // and updates during whose frame at least one spawn was dropped
+    unsigned int Spawned, Dropped, Overflows;
+    // constructor
+    ParticlePool(unsigned int capacity, float fadeRate = 2.5f);
+    // maximum number of live particles
+    unsigned int Capacity() const { return static_cast<unsigned int>(this->Lives.size()); }
+    // add a particle; false (and counted as dropped) if the pool is full
+    bool Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+    // age, move and fade all live particles, then remove the dead ones
+    void Update(float dt);
+    // kill all particles
+    void Clear() { this->Count = 0; }
+private:
+    // a spawn was dropped since the last update
+    bool overflowed;
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include "particle_system.hpp"
+#include "gl_state.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+// particles per brick burst and per powerup pickup
+const unsigned int BRICK_BURST_PARTICLES = 16;
+const unsigned int POWERUP_SPARK_PARTICLES = 24;
+// trail particles per ball and frame
+const unsigned int TRAIL_PARTICLES = 2;
+
+ParticleSystem::ParticleSystem(Shader shader, Shader updateShader, Texture2D texture, uint64_t seed)
+    : Pool(PARTICLE_BUDGET), Throttled(0), pendingParticles(0), spawnBudget(0), trailCursor(0), rng(seed), shader(shader), texture(texture),
+      backend(PARTICLES_CPU), gpuAvailable(false), updateShader(updateShader), current(0), gpuCursor(0)
+{
+    this->Init();
+}
+
+ParticleSystem::~ParticleSystem()
+{
+    glDeleteVertexArrays(1, &this->VAO);
+    glDeleteBuffers(1, &this->instanceVBO);
+    if (this->gpuAvailable)
+    {
+        glDeleteVertexArrays(2, this->updateVAOs);
+        glDeleteVertexArrays(2, this->drawVAOs);
+        glDeleteBuffers(2, this->gpuBuffers);
+    }
+}
+
+bool ParticleSystem::SetBackend(ParticleBackend backend)
+{
+    if (backend == PARTICLES_GPU && !this->gpuAvailable)
+    {
+        std::cout << "ERROR::PARTICLES: GPU particles unavailable, staying on the CPU" << std::endl;
+        return false;
+    }
+
+    // start over empty
+    this->Pool.Clear();
+    if (this->gpuAvailable)
+    {
+        std::vector<GpuParticle> empty(PARTICLE_BUDGET, GpuParticle());
+        for (unsigned int buffer : this->gpuBuffers)
+        {
+            GLState::BindArrayBuffer(buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, empty.size() * sizeof(GpuParticle), empty.data());
+        }
+        GLState::BindArrayBuffer(0);
+    }
+    this->backend = backend;
+    return true;
+}
+
+void ParticleSystem::OnBrickDestroyed(const GameLevel& level, unsigned int brick)
+{
+    this->AddBurst({ level.BrickPositions[brick], level.BrickSizes[brick], level.BrickColor(brick), BRICK_BURST_PARTICLES, 150.0f });
+}
+
+void ParticleSystem::OnPowerUpActivated(const PowerUp& powerUp)
+{
+    this->AddBurst({ powerUp.Position, powerUp.Size, powerUp.Color, POWERUP_SPARK_PARTICLES, 250.0f });
+}
+
+void ParticleSystem::AddBurst(const ParticleBurst& burst)
+{
+    // a frame never spawns more than its budget, so don't queue more than that either
+    if (this->pendingParticles + burst.Count > PARTICLE_SPAWN_BUDGET)
+    {
+        this->Throttled += burst.Count;
+        return;
+    }
+    this->bursts.push_back(burst);
+    this->pendingParticles += burst.Count;
+}
+
+void ParticleSystem::Emit(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life)
+{
+    if (this->spawnBudget == 0)
+    {
+        ++this->Throttled;
+        return;
+    }
+    --this->spawnBudget;
+    if (this->backend == PARTICLES_GPU)
+        this->spawns.push_back({ position, velocity, color, life });
+    else
+        this->Pool.Spawn(position, velocity, color, life);
+}
+
+void ParticleSystem::Update(const Game& game, float dt)
+{
+    this->spawnBudget = PARTICLE_SPAWN_BUDGET;
+
+    // events first: bursts
+    for (const ParticleBurst& burst : this->bursts)
+    {
+        for (unsigned int i = 0; i < burst.Count; ++i)
+        {
+            glm::vec2 position = burst.Position + burst.Size * glm::vec2(this->rng.NextFloat(), this->rng.NextFloat());
+            glm::vec2 velocity = (glm::vec2(this->rng.NextFloat(), this->rng.NextFloat()) * 2.0f - 1.0f) * burst.Speed;
+            this->Emit(position, velocity, glm::vec4(burst.Color, 1.0f), 0.4f);
+        }
+    }
+    this->bursts.clear();
+    this->pendingParticles = 0;
+
+    // then the ball trails with what's left of the budget
+    unsigned int balls = static_cast<unsigned int>(game.Balls.size());
+    unsigned int trails = std::min(balls, this->spawnBudget / TRAIL_PARTICLES);
+    this->Throttled += (balls - trails) * TRAIL_PARTICLES;
+    for (unsigned int i = 0; i < trails; ++i)
+    {
+        const BallObject& ball = game.Balls[(this->trailCursor + i) % balls];
+        for (unsigned int j = 0; j < TRAIL_PARTICLES; ++j)
+        {
+            float random = (static_cast<int>(this->rng.NextUInt(100)) - 50) / 10.0f;
+            float rColor = 0.5f + (this->rng.NextUInt(100) / 100.0f);
+            this->Emit(ball.Position + random + glm::vec2(ball.Radius / 2.0f), ball.Velocity * 0.1f, glm::vec4(rColor, rColor, rColor, 1.0f), 1.0f);
+        }
+    }
+    this->trailCursor = balls ? (this->trailCursor + trails) % balls : 0;
+
+    // update all live particles
+    if (this->backend == PARTICLES_GPU)
+        this->UpdateGpu(dt);
+    else
+        this->Pool.Update(dt);
+}
+
+void ParticleSystem::UpdateGpu(float dt)
+{
+    // write the new particles into the ring, wrapping around at the end
+    GLState::BindArrayBuffer(this->gpuBuffers[this->current]);
+    for (size_t uploaded = 0; uploaded < this->spawns.size();)
+    {
+        size_t count = std::min(this->spawns.size() - uploaded, static_cast<size_t>(PARTICLE_BUDGET - this->gpuCursor));
+        glBufferSubData(GL_ARRAY_BUFFER, this->gpuCursor * sizeof(GpuParticle), count * sizeof(GpuParticle), &this->spawns[uploaded]);
+        uploaded += count;
+        this->gpuCursor = (this->gpuCursor + count) % PARTICLE_BUDGET;
+    }
+    this->spawns.clear();
+
+    // advance every slot from the current buffer into the other one; nothing is rasterized
+    this->updateShader.Use();
+    this->updateShader.SetFloat(this->dtUniform, dt);
+    this->updateShader.SetFloat(this->fadeRateUniform, this->Pool.FadeRate);
+    glEnable(GL_RASTERIZER_DISCARD);
+    GLState::BindVertexArray(this->updateVAOs[this->current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->gpuBuffers[1 - this->current]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, PARTICLE_BUDGET);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    this->current = 1 - this->current;
+}
+
+// render all particles
+void ParticleSystem::Draw()
+{
+    // GPU: draw every slot straight from the latest buffer (the vertex shader culls the dead ones)
+    if (this->backend == PARTICLES_GPU)
+    {
+        this->shader.Use();
+        GLState::ActiveTexture(0);
+        this->texture.Bind();
+        GLState::BindVertexArray(this->drawVAOs[this->current]);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, PARTICLE_BUDGET);
+        return;
+    }
+
+    unsigned int count = this->Pool.Count;
+    if (count == 0)
+        return;
+
+    // upload the live positions and colors straight from the pool (orphaning the
+    // buffer so the previous frame's draw doesn't stall us); colors follow the
+    // capacity's worth of positions
+    unsigned int capacity = this->Pool.Capacity();
+    GLState::BindArrayBuffer(this->instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * (sizeof(glm::vec2) + sizeof(glm::vec4)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::vec2), this->Pool.Positions.data());
+    glBufferSubData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec2), count * sizeof(glm::vec4), this->Pool.Colors.data());
+
+    this->shader.Use();
+    GLState::ActiveTexture(0);
+    this->texture.Bind();
+    GLState::BindVertexArray(this->VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(count));
+}
+
+void ParticleSystem::Init()
+{
+    // set up mesh and attribute properties
+    unsigned int VBO;
+    float particle_quad[] = {
+        0.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f,
+
+        0.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, 1.0f, 1.0f, 1.0f,
+        1.0f, 0.0f, 1.0f, 0.0f
+    };
+    glGenVertexArrays(1, &this->VAO);
+    glGenBuffers(1, &VBO);
+    GLState::BindVertexArray(this->VAO);
+    // fill mesh buffer
+    GLState::BindArrayBuffer(VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
+    // set mesh attributes
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    // per-instance offsets and colors (two blocks of the same buffer), streamed in by Draw
+    unsigned int capacity = this->Pool.Capacity();
+    glGenBuffers(1, &this->instanceVBO);
+    GLState::BindArrayBuffer(this->instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * (sizeof(glm::vec2) + sizeof(glm::vec4)), nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)(capacity * sizeof(glm::vec2)));
+    glVertexAttribDivisor(2, 1);
+    GLState::BindVertexArray(0);
+    GLState::BindArrayBuffer(0);
+
+    // the GPU backend needs a working update shader
+    if (this->updateShader.IsLinked())
+        this->InitGpu(VBO);
+}
+
+void ParticleSystem::InitGpu(unsigned int quadVBO)
+{
+    this->dtUniform = this->updateShader.GetUniform("dt");
+    this->fadeRateUniform = this->updateShader.GetUniform("fadeRate");
+
+    // two zeroed (dead) particle buffers
+    std::vector<GpuParticle> empty(PARTICLE_BUDGET, GpuParticle());
+    glGenBuffers(2, this->gpuBuffers);
+    glGenVertexArrays(2, this->updateVAOs);
+    glGenVertexArrays(2, this->drawVAOs);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        GLState::BindArrayBuffer(this->gpuBuffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, empty.size() * sizeof(GpuParticle), empty.data(), GL_DYNAMIC_COPY);
+
+        // update: one vertex per particle
+        GLState::BindVertexArray(this->updateVAOs[i]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Velocity));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Color));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Life));
+
+        // draw: the quad per vertex, offset and color per instance (same inputs as the CPU backend)
+        GLState::BindVertexArray(this->drawVAOs[i]);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, Color));
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(2, 1);
+        GLState::BindArrayBuffer(quadVBO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    }
+    GLState::BindVertexArray(0);
+    GLState::BindArrayBuffer(0);
+
+    this->gpuAvailable = true;
+}
@@ -0,0 +1,120 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.hpp"
+#include "texture.hpp"
+#include "game.hpp"
+#include "game_listener.hpp"
+#include "particle_pool.hpp"
+#include "random.hpp"
+#include "render_queue.hpp"
+
+
+// Most particles alive at once, over all emitters
+const unsigned int PARTICLE_BUDGET = 20000;
+// Most particles spawned per frame, over all emitters
+const unsigned int PARTICLE_SPAWN_BUDGET = 2000;
+
+
+// Where particles are simulated
+enum ParticleBackend {
+    PARTICLES_CPU, // ParticlePool, uploaded for drawing every frame
+    PARTICLES_GPU  // buffer objects advanced by a transform feedback shader
+};
+
+
+// Particle as stored in the GPU backend's buffers
+struct GpuParticle {
+    glm::vec2 Position, Velocity;
+    glm::vec4 Color;
+    float     Life;
+};
+
+
+// One-shot emitter: Count particles spread over the box [Position, Position + Size],
+// flying off in random directions at up to Speed
+struct ParticleBurst {
+    glm::vec2    Position, Size;
+    glm::vec3    Color;
+    unsigned int Count;
+    float        Speed;
+};
+
+
+// ParticleSystem owns every particle effect of the game: a trail behind
+// each ball, a burst when a brick shatters and sparks when a powerup is
+// picked up. All emitters share one pool and one instanced draw call, and
+// the budgets hold for all of them together, so an event storm (a
+// pass-through ball ripping through a row of bricks, thousands of balls)
+// costs at most a fixed amount of work per frame. Particles that don't
+// fit are counted, never spawned.
+// Add it to the Game as a listener to get the brick and powerup effects.
+// Particles are simulated on the CPU or, when the GL supports the update
+// shader, on the GPU: there the state lives in two buffers that a vertex
+// shader ping-pongs between with transform feedback, and the CPU only
+// uploads the frame's new particles into a ring of slots. The GPU ring
+// overwrites its oldest slot when full instead of dropping new particles.
+class ParticleSystem : public GameListener, public Drawable
+{
+public:
+    // CPU backend state: all live particles and the pool's drop counters
+    ParticlePool Pool;
+    // spawns refused because the frame's spawn budget was used up
+    unsigned int Throttled;
+    // constructor (the update shader is only needed for the GPU backend)
+    ParticleSystem(Shader shader, Shader updateShader, Texture2D texture, uint64_t seed = 0);
+    // destructor
+    ~ParticleSystem();
+    // switch backends (all live particles are cleared); false if the GPU one isn't available
+    bool SetBackend(ParticleBackend backend);
+    ParticleBackend GetBackend() const { return this->backend; }
+    // emit the queued bursts and the ball trails, then advance all particles by dt
+    void Update(const Game& game, float dt);
+    // render all live particles with a single instanced draw call; meant for
+    // additive blending (GL_SRC_ALPHA, GL_ONE), which the render queue sets up
+    void Draw() override;
+    // simulation events
+    void OnBrickDestroyed(const GameLevel& level, unsigned int brick) override;
+    void OnPowerUpActivated(const PowerUp& powerUp) override;
+private:
+    // bursts requested since the last update and the particles they will spawn
+    std::vector<ParticleBurst> bursts;
+    unsigned int pendingParticles;
+    // spawns left in the current frame's budget
+    unsigned int spawnBudget;
+    // first ball to get a trail this frame (rotates, so with too many balls all of them get their turn)
+    unsigned int trailCursor;
+    // random spread/brightness of spawned particles
+    Random rng;
+    // render state
+    Shader shader;
+    Texture2D texture;
+    unsigned int VAO;
+    unsigned int instanceVBO;
+    // GPU backend: ping-pong particle buffers (current holds the latest state), a VAO
+    // per buffer to update from and one to draw from, the next ring slot to spawn into
+    // and the particles spawned this frame
+    ParticleBackend backend;
+    bool gpuAvailable;
+    Shader updateShader;
+    UniformHandle dtUniform, fadeRateUniform;
+    unsigned int gpuBuffers[2], updateVAOs[2], drawVAOs[2];
+    unsigned int current;
+    unsigned int gpuCursor;
+    std::vector<GpuParticle> spawns;
+    // initializes buffer and vertex attributes
+    void Init();
+    void InitGpu(unsigned int quadVBO);
+    // GPU backend: upload this frame's spawns and advance all particles by dt
+    void UpdateGpu(float dt);
+    // queue a burst (within the spawn budget)
+    void AddBurst(const ParticleBurst& burst);
+    // spawn a particle if the frame's budget allows it
+    void Emit(glm::vec2 position, glm::vec2 velocity, glm::vec4 color, float life);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+//Small, fast, seedable pseudo random number generator (PCG32).
+//Every Game/ParticleSystem owns its own instance instead of sharing
+//the global rand() state, so a session seeded the same way plays out
+//the same way, and sessions can run side by side on different threads.
+class Random {
+
+public:
+	//Constructor
+	Random(uint64_t seed = 0) { this->Seed(seed); }
+
+	//Restart the sequence from the given seed
+	void Seed(uint64_t seed)
+	{
+		this->seed = seed;
+		this->state = 0u;
+		this->Next();
+		this->state += seed;
+		this->Next();
+	}
+
+	//Seed the current sequence was started from
+	uint64_t GetSeed() const { return this->seed; }
+
+	//Next 32 random bits
+	uint32_t Next()
+	{
+		uint64_t old = this->state;
+		this->state = old * 6364136223846793005ULL + INCREMENT;
+		uint32_t xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+		uint32_t rot = static_cast<uint32_t>(old >> 59u);
+		return (xorShifted >> rot) | (xorShifted << ((32u - rot) & 31u));
+	}
+
+	//Uniform integer in [0, bound)
+	uint32_t NextUInt(uint32_t bound)
+	{
+		return static_cast<uint32_t>((static_cast<uint64_t>(this->Next()) * bound) >> 32);
+	}
+
+	//Uniform float in [0, 1)
+	float NextFloat()
+	{
+		return (this->Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+private:
+	//Stream selector (must be odd)
+	static const uint64_t INCREMENT = 1442695040888963407ULL;
+
+	uint64_t state;
+	uint64_t seed;
+};
+
+#endif
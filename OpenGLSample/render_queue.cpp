@@ -0,0 +1,91 @@
+#include "render_queue.hpp"
+#include "gl_state.hpp"
+
+#include <algorithm>
+
+RenderQueue::RenderQueue(SpriteRenderer* sprites, unsigned int spriteShader)
+	: Commands(0), StateChanges(0), BlendChanges(0), ShaderChanges(0), TextureChanges(0),
+	spriteRenderer(sprites), spriteShader(spriteShader), blend(BLEND_ALPHA), shader(0), texture(0) {}
+
+uint64_t RenderQueue::MakeKey(RenderLayer layer, BlendMode blend, unsigned int shader, unsigned int texture) {
+
+	//layer:8 | blend:8 | shader:16 | texture:32
+	return (uint64_t(layer) << 56) | (uint64_t(blend) << 48) | (uint64_t(shader & 0xFFFF) << 32) | texture;
+}
+
+void RenderQueue::Begin() {
+	this->Commands = this->StateChanges = 0;
+	this->BlendChanges = this->ShaderChanges = this->TextureChanges = 0;
+	this->shader = this->texture = 0;
+}
+
+void RenderQueue::Submit(RenderLayer layer, BlendMode blend, const Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color) {
+
+	Command command = { MakeKey(layer, blend, this->spriteShader, texture.ID), static_cast<unsigned int>(this->commands.size()), nullptr, static_cast<unsigned int>(this->sprites.size()) };
+	this->commands.push_back(command);
+	this->sprites.push_back({ texture, position, size, rotate, color });
+}
+
+void RenderQueue::Submit(RenderLayer layer, BlendMode blend, unsigned int shader, unsigned int texture, Drawable* drawable) {
+
+	Command command = { MakeKey(layer, blend, shader, texture), static_cast<unsigned int>(this->commands.size()), drawable, 0 };
+	this->commands.push_back(command);
+}
+
+void RenderQueue::Execute() {
+
+	std::sort(this->commands.begin(), this->commands.end(), [](const Command& a, const Command& b) {
+		return a.Key != b.Key ? a.Key < b.Key : a.Sequence < b.Sequence;
+	});
+
+	for (const Command& command : this->commands) {
+
+		//Only what differs from the previous command counts as a change
+		BlendMode mode = static_cast<BlendMode>((command.Key >> 48) & 0xFF);
+		unsigned int shader = static_cast<unsigned int>((command.Key >> 32) & 0xFFFF);
+		unsigned int texture = static_cast<unsigned int>(command.Key);
+
+		this->ApplyBlend(mode);
+		if (shader != this->shader) {
+			this->shader = shader;
+			++this->ShaderChanges;
+			++this->StateChanges;
+		}
+		if (texture != this->texture) {
+			this->texture = texture;
+			++this->TextureChanges;
+			++this->StateChanges;
+		}
+
+		//Sprites go into the batch; anything else draws after what's batched so far
+		if (command.Target) {
+			this->spriteRenderer->Flush();
+			command.Target->Draw();
+		}
+		else {
+			const SpriteCommand& sprite = this->sprites[command.Sprite];
+			this->spriteRenderer->Submit(sprite.Texture, sprite.Position, sprite.Size, sprite.Rotate, sprite.Color);
+		}
+	}
+	this->spriteRenderer->Flush();
+
+	//Leave the default blend mode for whatever draws outside of the queue
+	this->ApplyBlend(BLEND_ALPHA);
+
+	this->Commands += static_cast<unsigned int>(this->commands.size());
+	this->commands.clear();
+	this->sprites.clear();
+}
+
+void RenderQueue::ApplyBlend(BlendMode mode) {
+
+	if (mode == this->blend)
+		return;
+
+	//Queued sprites are drawn with the old mode
+	this->spriteRenderer->Flush();
+	GLState::BlendFunc(GL_SRC_ALPHA, mode == BLEND_ADDITIVE ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+	this->blend = mode;
+	++this->BlendChanges;
+	++this->StateChanges;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "sprite_renderer.hpp"
+#include "texture.hpp"
+
+//Draw order, back to front (the most significant part of a sort key)
+enum RenderLayer : uint8_t {
+	LAYER_WORLD,
+	LAYER_PLAYER,
+	LAYER_PARTICLES,
+	LAYER_OBJECTS,
+	LAYER_UI
+};
+
+//Blend modes the queue can set up
+enum BlendMode : uint8_t {
+	BLEND_ALPHA,	//GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA (the default)
+	BLEND_ADDITIVE	//GL_SRC_ALPHA, GL_ONE
+};
+
+//Anything that draws itself in one go with the blend mode the queue set up
+//(it still binds its own shader and textures)
+class Drawable {
+
+public:
+	virtual ~Drawable() {}
+
+	virtual void Draw() = 0;
+};
+
+//RenderQueue collects a pass's draws with a sort key (layer, blend mode,
+//shader, texture) and executes them sorted, so draws sharing state end up
+//next to each other: sprites with the same texture merge into one batch
+//and the blend mode is only switched when it actually changes. Draws with
+//equal keys keep their submission order. It counts the state changes of
+//the frame for profiling.
+class RenderQueue {
+
+public:
+	//Per frame counters (reset by Begin)
+	unsigned int Commands;
+	unsigned int StateChanges; //Sum of the three below
+	unsigned int BlendChanges, ShaderChanges, TextureChanges;
+
+	//Constructor; sprite commands are drawn with the given renderer, whose shader is spriteShader
+	RenderQueue(SpriteRenderer* sprites, unsigned int spriteShader);
+
+	//Sort key of a draw
+	static uint64_t MakeKey(RenderLayer layer, BlendMode blend, unsigned int shader, unsigned int texture);
+
+	//Start a new frame (resets the counters)
+	void Begin();
+
+	//Queue a sprite
+	void Submit(RenderLayer layer, BlendMode blend, const Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+
+	//Queue a drawable using the given shader and texture (IDs, only used for sorting and counting)
+	void Submit(RenderLayer layer, BlendMode blend, unsigned int shader, unsigned int texture, Drawable* drawable);
+
+	//Draw everything queued in key order and empty the queue
+	void Execute();
+
+private:
+	struct Command {
+		uint64_t Key;
+		unsigned int Sequence; //Submission order, breaks ties
+		Drawable* Target;	   //nullptr for sprites
+		unsigned int Sprite;   //Index into sprites
+	};
+
+	struct SpriteCommand {
+		Texture2D Texture;
+		glm::vec2 Position, Size;
+		float Rotate;
+		glm::vec3 Color;
+	};
+
+	SpriteRenderer* spriteRenderer;
+	unsigned int spriteShader;
+
+	std::vector<Command> commands;
+	std::vector<SpriteCommand> sprites;
+
+	//State the last executed command left behind (blend stays set between passes)
+	BlendMode blend;
+	unsigned int shader, texture;
+
+	//Switch the blend mode if it differs
+	void ApplyBlend(BlendMode mode);
+};
+
+#endif
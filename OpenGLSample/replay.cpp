@@ -0,0 +1,203 @@
+#include "replay.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+//Replay file identification
+static const char REPLAY_MAGIC[4] = { 'B', 'R', 'K', 'R' };
+static const uint8_t REPLAY_VERSION = 2;
+
+//Little endian writers/readers
+static void WriteBytes(std::ostream& out, uint64_t value, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+static uint64_t ReadBytes(std::istream& in, unsigned int count)
+{
+    uint64_t value = 0;
+    for (unsigned int i = 0; i < count; ++i)
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(in.get())) << (8 * i);
+    return value;
+}
+
+//Variable length integers: 7 bits per byte, high bit set while more bytes follow
+static void WriteVarint(std::ostream& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+static uint64_t ReadVarint(std::istream& in)
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64 && in; shift += 7)
+    {
+        uint8_t byte = static_cast<uint8_t>(in.get());
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    return value;
+}
+
+bool Replay::Save(const char* file) const
+{
+    std::ofstream out(file, std::ios::binary);
+    if (!out)
+    {
+        std::cout << "ERROR::REPLAY: Could not open " << file << " for writing" << std::endl;
+        return false;
+    }
+
+    uint32_t stepBits;
+    std::memcpy(&stepBits, &this->StepTime, sizeof(stepBits));
+
+    out.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    WriteBytes(out, REPLAY_VERSION, 1);
+    WriteBytes(out, this->Seed, 8);
+    WriteBytes(out, this->Level, 4);
+    WriteBytes(out, this->Width, 4);
+    WriteBytes(out, this->Height, 4);
+    WriteBytes(out, stepBits, 4);
+    WriteBytes(out, this->EndTick, 8);
+    WriteBytes(out, this->Events.size(), 4);
+
+    uint64_t lastTick = 0;
+    for (const KeyEvent& event : this->Events)
+    {
+        WriteVarint(out, event.Tick - lastTick);
+        WriteVarint(out, event.Key);
+        WriteBytes(out, (event.Down ? 1 : 0) | (event.Processed ? 2 : 0), 1);
+        lastTick = event.Tick;
+    }
+
+    if (!out)
+    {
+        std::cout << "ERROR::REPLAY: Failed to write " << file << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Replay::Load(const char* file)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+    {
+        std::cout << "ERROR::REPLAY: Could not open " << file << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 || ReadBytes(in, 1) != REPLAY_VERSION)
+    {
+        std::cout << "ERROR::REPLAY: " << file << " is not a version " << int(REPLAY_VERSION) << " replay" << std::endl;
+        return false;
+    }
+
+    this->Seed = ReadBytes(in, 8);
+    this->Level = static_cast<unsigned int>(ReadBytes(in, 4));
+    this->Width = static_cast<unsigned int>(ReadBytes(in, 4));
+    this->Height = static_cast<unsigned int>(ReadBytes(in, 4));
+    uint32_t stepBits = static_cast<uint32_t>(ReadBytes(in, 4));
+    std::memcpy(&this->StepTime, &stepBits, sizeof(stepBits));
+    this->EndTick = ReadBytes(in, 8);
+    uint32_t count = static_cast<uint32_t>(ReadBytes(in, 4));
+
+    this->Events.clear();
+    uint64_t tick = 0;
+    for (uint32_t i = 0; i < count && in; ++i)
+    {
+        KeyEvent event;
+        tick += ReadVarint(in);
+        event.Tick = tick;
+        uint64_t key = ReadVarint(in);
+        uint8_t flags = static_cast<uint8_t>(ReadBytes(in, 1));
+        if (key >= GAME_KEYS)
+        {
+            std::cout << "ERROR::REPLAY: " << file << " has an event for invalid key " << key << std::endl;
+            return false;
+        }
+        event.Key = static_cast<uint16_t>(key);
+        event.Down = (flags & 1) != 0;
+        event.Processed = (flags & 2) != 0;
+        this->Events.push_back(event);
+    }
+
+    if (!in)
+    {
+        std::cout << "ERROR::REPLAY: " << file << " is truncated" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ReplayRecorder::Begin(const Game& game, float stepTime)
+{
+    this->Data = Replay();
+    this->Data.Seed = game.Rng.GetSeed();
+    this->Data.Level = game.Level;
+    this->Data.Width = game.Width;
+    this->Data.Height = game.Height;
+    this->Data.StepTime = stepTime;
+
+    //A fresh game starts with every key released
+    std::memset(this->keys, 0, sizeof(this->keys));
+    std::memset(this->keysProcessed, 0, sizeof(this->keysProcessed));
+}
+
+void ReplayRecorder::Capture(const Game& game)
+{
+    //Nothing changed (the common case)
+    if (std::memcmp(game.Keys, this->keys, sizeof(this->keys)) == 0 &&
+        std::memcmp(game.KeysProcessed, this->keysProcessed, sizeof(this->keysProcessed)) == 0)
+        return;
+
+    for (uint16_t key = 0; key < GAME_KEYS; ++key)
+    {
+        if (game.Keys[key] != this->keys[key] || game.KeysProcessed[key] != this->keysProcessed[key])
+        {
+            this->keys[key] = game.Keys[key];
+            this->keysProcessed[key] = game.KeysProcessed[key];
+            this->Data.Events.push_back({ game.Tick, key, game.Keys[key], game.KeysProcessed[key] });
+        }
+    }
+}
+
+bool ReplayRecorder::Save(const Game& game, const char* file)
+{
+    this->Data.EndTick = game.Tick;
+    return this->Data.Save(file);
+}
+
+bool ReplayPlayer::Begin(Game& game)
+{
+    if (this->Data.Width != game.Width || this->Data.Height != game.Height || this->Data.Level >= game.Levels.size())
+    {
+        std::cout << "ERROR::REPLAY: Replay was recorded for a different game setup" << std::endl;
+        return false;
+    }
+
+    game.Rng.Seed(this->Data.Seed);
+    game.Level = this->Data.Level;
+    this->next = 0;
+    return true;
+}
+
+void ReplayPlayer::Apply(Game& game)
+{
+    while (this->next < this->Data.Events.size() && this->Data.Events[this->next].Tick <= game.Tick)
+    {
+        const KeyEvent& event = this->Data.Events[this->next++];
+        game.Keys[event.Key] = event.Down;
+        game.KeysProcessed[event.Key] = event.Processed;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "game.hpp"
+
+//A change of one key's state, applied right before the simulation step Tick
+struct KeyEvent {
+	uint64_t Tick;
+	uint16_t Key;
+	bool Down;		 //Game::Keys[Key]
+	bool Processed; //Game::KeysProcessed[Key]
+};
+
+//Everything needed to play a session back: the session's setup plus
+//every change to Game::Keys/KeysProcessed in tick order.
+//
+//File format (little endian):
+//  "BRKR" magic, u8 version, u64 seed, u32 level, u32 width, u32 height,
+//  f32 step time, u64 end tick, u32 event count, then per event:
+//  varint tick delta (from the previous event), varint key, u8 flags (1 = down, 2 = processed)
+struct Replay {
+	uint64_t Seed;
+	unsigned int Level;
+	unsigned int Width, Height;
+	float StepTime;
+	uint64_t EndTick; //Steps the session ran for (it may idle long after the last event)
+	std::vector<KeyEvent> Events;
+
+	Replay() : Seed(0), Level(0), Width(0), Height(0), StepTime(0.0f), EndTick(0) {}
+
+	//Write/read a replay file; returns false (and logs) on failure
+	bool Save(const char* file) const;
+	bool Load(const char* file);
+};
+
+//Records a session's input. Call Begin on a freshly initialized game
+//(after seeding it) and Capture right before every Game::Step.
+class ReplayRecorder {
+
+public:
+	Replay Data;
+
+	//Start recording the given game
+	void Begin(const Game& game, float stepTime);
+
+	//Record every key that changed since the last capture
+	void Capture(const Game& game);
+
+	//Write the recording so far; the game's current tick ends the session
+	bool Save(const Game& game, const char* file);
+
+private:
+	bool keys[GAME_KEYS];
+	bool keysProcessed[GAME_KEYS];
+};
+
+//Feeds a recorded session back into a game. Call Begin on a freshly
+//initialized game and Apply right before every Game::Step.
+class ReplayPlayer {
+
+public:
+	Replay Data;
+
+	ReplayPlayer() : next(0) {}
+
+	//Set the game up as it was when recording started; false if the replay doesn't fit this game
+	bool Begin(Game& game);
+
+	//Apply all key changes recorded for the game's current tick
+	void Apply(Game& game);
+
+	//True once every recorded event has been applied
+	bool Finished() const { return this->next >= this->Data.Events.size(); }
+
+private:
+	size_t next;
+};
+
+#endif
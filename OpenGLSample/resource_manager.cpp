@@ -1,10 +1,14 @@
 #include "resource_manager.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <fstream>
 
 #include "stb_image.h"
+#include "texture_atlas.hpp"
+#include "gl_state.hpp"
 
 //Instantiate static variables
 std::map<std::string, Texture2D> ResourceManager::Textures;
@@ -15,6 +19,36 @@ Shader ResourceManager::LoadShader(const char* vShaderFile, const char* fShaderF
 	return Shaders[name];
 }
 
+Shader ResourceManager::LoadTransformFeedbackShader(const char* vShaderFile, const std::vector<const char*>& varyings, std::string name) {
+
+	//read the vertex source
+	std::ifstream vertexShaderFile(vShaderFile);
+	std::stringstream vShaderStream;
+	vShaderStream << vertexShaderFile.rdbuf();
+	std::string vertexCode = vShaderStream.str();
+	if (vertexCode.empty())
+		std::cout << "ERROR::SHADER: Failed to read shader file " << vShaderFile << std::endl;
+
+	Shader shader;
+	shader.CompileTransformFeedback(vertexCode.c_str(), varyings.data(), static_cast<int>(varyings.size()));
+	Shaders[name] = shader;
+	return shader;
+}
+
+Shader ResourceManager::LoadShaderVariant(const char* vShaderFile, const char* fShaderFile, const std::vector<std::string>& defines, std::string name) {
+
+	for (const std::string& define : defines)
+		name += "+" + define;
+
+	//already compiled
+	auto iter = Shaders.find(name);
+	if (iter != Shaders.end())
+		return iter->second;
+
+	Shaders[name] = LoadShaderFromFile(vShaderFile, fShaderFile, nullptr, defines);
+	return Shaders[name];
+}
+
 Shader ResourceManager::GetShader(std::string name) {
 	return Shaders[name];
 }
@@ -24,6 +58,54 @@ Texture2D ResourceManager::LoadTexture(const char* file, bool alpha, std::string
 	return Textures[name];
 }
 
+bool ResourceManager::LoadAtlas(const std::vector<std::pair<const char*, std::string>>& files, unsigned int pageSize) {
+
+	TextureAtlas atlas(pageSize, pageSize);
+
+	//load every image as RGBA
+	for (const auto& file : files) {
+		int width, height, nrChannels;
+		unsigned char* data = stbi_load(file.first, &width, &height, &nrChannels, 4);
+		if (!data) {
+			std::cout << "ERROR::ATLAS: Failed to load " << file.first << std::endl;
+			width = height = 0;
+		}
+		atlas.Add(width, height, data);
+		stbi_image_free(data);
+	}
+
+	if (!atlas.Pack())
+		return false;
+
+	//one texture per page
+	std::vector<Texture2D> pages;
+	for (std::vector<unsigned char>& pixels : atlas.Pages) {
+		Texture2D page;
+		page.Internal_Format = GL_RGBA;
+		page.Image_Format = GL_RGBA;
+		page.Wrap_U = page.Wrap_V = GL_CLAMP_TO_EDGE;
+		page.Generate(pageSize, pageSize, pixels.data());
+		pages.push_back(page);
+	}
+
+	//every image is its page with a sub-rectangle
+	for (size_t i = 0; i < files.size(); ++i) {
+		const AtlasRect& rect = atlas.Rects[i];
+		Texture2D texture = pages[rect.Page];
+		texture.Width = rect.Width;
+		texture.Height = rect.Height;
+		texture.UVMin = glm::vec2(rect.X, rect.Y) / static_cast<float>(pageSize);
+		texture.UVMax = glm::vec2(rect.X + rect.Width, rect.Y + rect.Height) / static_cast<float>(pageSize);
+		Textures[files[i].second] = texture;
+	}
+	return true;
+}
+
+Texture2D ResourceManager::AliasTexture(std::string name, std::string existing) {
+	Textures[name] = Textures[existing];
+	return Textures[name];
+}
+
 Texture2D ResourceManager::GetTexture(std::string name)
 {
 	return Textures[name];
@@ -35,13 +117,20 @@ void ResourceManager::Clear() {
 		glDeleteProgram(iter.second.ID);
 	}
 
-	//properly delete all textures
+	//properly delete all textures (atlas entries share their page's texture)
+	std::set<unsigned int> textures;
 	for (auto iter : Textures) {
-		glDeleteTextures(1, &iter.second.ID);
+		textures.insert(iter.second.ID);
+	}
+	for (unsigned int id : textures) {
+		glDeleteTextures(1, &id);
 	}
+
+	//The deleted names may come back for new objects
+	GLState::Invalidate();
 }
 
-Shader ResourceManager::LoadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile) {
+Shader ResourceManager::LoadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile, const std::vector<std::string>& defines) {
 
 	//1. retrieve the vert/frag source from filepath
 	std::string vertexCode;
@@ -79,6 +168,14 @@ Shader ResourceManager::LoadShaderFromFile(const char* vShaderFile, const char*
 		std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
 	}
 
+	//specialize the sources
+	if (!defines.empty()) {
+		vertexCode = AddDefines(vertexCode, defines);
+		fragmentCode = AddDefines(fragmentCode, defines);
+		if (gShaderFile != nullptr)
+			geometryCode = AddDefines(geometryCode, defines);
+	}
+
 	const char* vShaderCode = vertexCode.c_str();
 	const char* fShaderCode = fragmentCode.c_str();
 	const char* gShaderCode = geometryCode.c_str();
@@ -89,6 +186,27 @@ Shader ResourceManager::LoadShaderFromFile(const char* vShaderFile, const char*
 	return shader;
 }
 
+std::string ResourceManager::AddDefines(const std::string& code, const std::vector<std::string>& defines) {
+
+	std::string block;
+	for (const std::string& define : defines)
+		block += "#define " + define + "\n";
+
+	//#version has to stay the first statement
+	size_t version = code.find("#version");
+	if (version == std::string::npos)
+		return block + code;
+	size_t insert = code.find('\n', version);
+	if (insert == std::string::npos)
+		return code + "\n" + block;
+
+	//keep compile errors pointing at the file's own line numbers
+	++insert;
+	size_t line = std::count(code.begin(), code.begin() + insert, '\n') + 1;
+	block += "#line " + std::to_string(line) + "\n";
+	return code.substr(0, insert) + block + code.substr(insert);
+}
+
 Texture2D ResourceManager::LoadTextureFromFile(const char* file, bool alpha) {
 
 	//Create Texture Object
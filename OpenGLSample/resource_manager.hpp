@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -22,12 +23,27 @@ public:
 	//loads (and generates) a shader program from file. Can load vert, frag, and geo
 	static Shader LoadShader(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile, std::string name);
 
+	//loads (and generates) a vertex-only transform feedback program from file
+	static Shader LoadTransformFeedbackShader(const char* vShaderFile, const std::vector<const char*>& varyings, std::string name);
+
+	//loads (and generates) a variant of a shader program compiled with each of the defines
+	//(#define NAME) added to its sources; variants are cached, so every combination
+	//is only compiled once and stored as name followed by its defines ("post+CHAOS+SHAKE")
+	static Shader LoadShaderVariant(const char* vShaderFile, const char* fShaderFile, const std::vector<std::string>& defines, std::string name);
+
 	//Retrieve a stored shader
 	static Shader GetShader(std::string name);
 
 	//load and gen texture from file.
 	static Texture2D LoadTexture(const char* file, bool alpha, std::string name);
 
+	//load several images and pack them into shared atlas pages; each one is stored
+	//under its name as its page's texture with the image's UV sub-rectangle
+	static bool LoadAtlas(const std::vector<std::pair<const char*, std::string>>& files, unsigned int pageSize = 2048);
+
+	//store an already loaded texture under another name as well (same texture object)
+	static Texture2D AliasTexture(std::string name, std::string existing);
+
 	//retrieve stored texture
 	static Texture2D GetTexture(std::string name);
 
@@ -39,7 +55,10 @@ private:
 	ResourceManager();
 
 	//Load and Gen a Shader from file
-	static Shader LoadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile = nullptr);
+	static Shader LoadShaderFromFile(const char* vShaderFile, const char* fShaderFile, const char* gShaderFile = nullptr, const std::vector<std::string>& defines = {});
+
+	//Add the defines to a shader source (right after its #version line)
+	static std::string AddDefines(const std::string& code, const std::vector<std::string>& defines);
 
 	//Load a single texture from file
 	static Texture2D LoadTextureFromFile(const char* file, bool alpha);
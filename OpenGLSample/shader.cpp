@@ -1,9 +1,26 @@
 #include "shader.hpp"
+#include "gl_state.hpp"
+#include "frame_uniforms.hpp"
 
+#include <cstring>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
+
+//One active uniform and the last value uploaded to it
+struct ShaderUniform {
+	int Location;
+	bool Known; //Value holds what the program has
+	alignas(16) unsigned char Value[sizeof(glm::mat4)];
+};
+
+struct UniformTable {
+	std::vector<ShaderUniform> Uniforms;
+	std::unordered_map<std::string, int> Names; //Name to index into Uniforms
+};
 
 Shader& Shader::Use() {
-	glUseProgram(this->ID);
+	GLState::UseProgram(this->ID);
 	return *this;
 }
 
@@ -42,6 +59,7 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
 
 	glLinkProgram(this->ID);
 	CheckCompileErrors(this->ID, "PROGRAM");
+	this->ReflectUniforms();
 
 	//Delete the shaders as they are linked and no longer needed
 	glDeleteShader(sVertex);
@@ -53,58 +71,175 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
 
 }
 
-void Shader::SetFloat(const char* name, float value, bool useShader) {
+void Shader::CompileTransformFeedback(const char* vertexSource, const char* const* varyings, int varyingCount) {
+
+	//Vertex
+	unsigned int sVertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(sVertex, 1, &vertexSource, NULL);
+	glCompileShader(sVertex);
+	CheckCompileErrors(sVertex, "VERTEX");
+
+	//Shader Program (the outputs must be declared before linking)
+	this->ID = glCreateProgram();
+	glAttachShader(this->ID, sVertex);
+	glTransformFeedbackVaryings(this->ID, varyingCount, varyings, GL_INTERLEAVED_ATTRIBS);
+	glLinkProgram(this->ID);
+	CheckCompileErrors(this->ID, "PROGRAM");
+	this->ReflectUniforms();
+
+	glDeleteShader(sVertex);
+}
+
+bool Shader::IsLinked() const {
+	int success;
+	glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+	return success != 0;
+}
+
+void Shader::ReflectUniforms() {
+
+	//A fresh table; copies of the old program keep theirs
+	this->uniforms = std::make_shared<UniformTable>();
+	if (!this->IsLinked())
+		return;
+
+	//Frame-global data comes from the shared uniform buffer
+	unsigned int frameBlock = glGetUniformBlockIndex(this->ID, "Frame");
+	if (frameBlock != GL_INVALID_INDEX)
+		glUniformBlockBinding(this->ID, frameBlock, FRAME_UNIFORM_BINDING);
+
+	int count = 0;
+	glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+
+	char name[256];
+	for (int i = 0; i < count; ++i) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(this->ID, static_cast<GLuint>(i), sizeof(name), &length, &size, &type, name);
+
+		//Arrays are reported as "name[0]"; they're set with the raw array calls and aren't cached
+		if (size > 1)
+			continue;
+
+		ShaderUniform uniform = {};
+		uniform.Location = glGetUniformLocation(this->ID, name);
+		uniform.Known = false;
+		if (uniform.Location < 0) //Uniform block members have no location
+			continue;
+
+		this->uniforms->Names[std::string(name, length)] = static_cast<int>(this->uniforms->Uniforms.size());
+		this->uniforms->Uniforms.push_back(uniform);
+	}
+}
+
+UniformHandle Shader::GetUniform(const char* name) const {
+
+	UniformHandle handle;
+	if (this->uniforms) {
+		auto found = this->uniforms->Names.find(name);
+		if (found != this->uniforms->Names.end())
+			handle.Index = found->second;
+	}
+	return handle;
+}
+
+int Shader::Changed(UniformHandle uniform, const void* value, size_t size) {
+
+	if (!uniform.IsValid())
+		return -1;
+
+	ShaderUniform& cached = this->uniforms->Uniforms[uniform.Index];
+	if (cached.Known && std::memcmp(cached.Value, value, size) == 0)
+		return -1;
+
+	std::memcpy(cached.Value, value, size);
+	cached.Known = true;
+	return cached.Location;
+}
+
+void Shader::SetFloat(UniformHandle uniform, float value, bool useShader) {
 	if (useShader)
 		this->Use();
-	glUniform1f(glGetUniformLocation(this->ID, name), value);
+	int location = this->Changed(uniform, &value, sizeof(value));
+	if (location >= 0)
+		glUniform1f(location, value);
 }
 
-void Shader::SetInteger(const char* name, int value, bool useShader) {
+void Shader::SetInteger(UniformHandle uniform, int value, bool useShader) {
 	if (useShader)
 		this->Use();
-	glUniform1i(glGetUniformLocation(this->ID, name), value);
+	int location = this->Changed(uniform, &value, sizeof(value));
+	if (location >= 0)
+		glUniform1i(location, value);
 }
 
-void Shader::SetVector2f(const char* name, const glm::vec2 &value, bool useShader) {
+void Shader::SetVector2f(UniformHandle uniform, const glm::vec2& value, bool useShader) {
 	if (useShader)
 		this->Use();
-	glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+	int location = this->Changed(uniform, glm::value_ptr(value), sizeof(value));
+	if (location >= 0)
+		glUniform2f(location, value.x, value.y);
 }
 
-void Shader::SetVector2f(const char* name, float x, float y, bool useShader) {
+void Shader::SetVector3f(UniformHandle uniform, const glm::vec3& value, bool useShader) {
 	if (useShader)
 		this->Use();
-	glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+	int location = this->Changed(uniform, glm::value_ptr(value), sizeof(value));
+	if (location >= 0)
+		glUniform3f(location, value.x, value.y, value.z);
 }
 
-void Shader::SetVector3f(const char* name, const glm::vec3 &value, bool useShader) {
+void Shader::SetVector4f(UniformHandle uniform, const glm::vec4& value, bool useShader) {
 	if (useShader)
 		this->Use();
-	glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+	int location = this->Changed(uniform, glm::value_ptr(value), sizeof(value));
+	if (location >= 0)
+		glUniform4f(location, value.x, value.y, value.z, value.w);
 }
 
-void Shader::SetVector3f(const char* name, float x, float y, float z, bool useShader) {
+void Shader::SetMatrix4(UniformHandle uniform, const glm::mat4& matrix, bool useShader) {
 	if (useShader)
 		this->Use();
-	glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+	int location = this->Changed(uniform, glm::value_ptr(matrix), sizeof(matrix));
+	if (location >= 0)
+		glUniformMatrix4fv(location, 1, false, glm::value_ptr(matrix));
+}
+
+void Shader::SetFloat(const char* name, float value, bool useShader) {
+	this->SetFloat(this->GetUniform(name), value, useShader);
+}
+
+void Shader::SetInteger(const char* name, int value, bool useShader) {
+	this->SetInteger(this->GetUniform(name), value, useShader);
+}
+
+void Shader::SetVector2f(const char* name, const glm::vec2 &value, bool useShader) {
+	this->SetVector2f(this->GetUniform(name), value, useShader);
+}
+
+void Shader::SetVector2f(const char* name, float x, float y, bool useShader) {
+	this->SetVector2f(this->GetUniform(name), glm::vec2(x, y), useShader);
+}
+
+void Shader::SetVector3f(const char* name, const glm::vec3 &value, bool useShader) {
+	this->SetVector3f(this->GetUniform(name), value, useShader);
+}
+
+void Shader::SetVector3f(const char* name, float x, float y, float z, bool useShader) {
+	this->SetVector3f(this->GetUniform(name), glm::vec3(x, y, z), useShader);
 }
 
 void Shader::SetVector4f(const char* name, const glm::vec4 &value, bool useShader) {
-	if (useShader)
-		this->Use();
-	glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+	this->SetVector4f(this->GetUniform(name), value, useShader);
 }
 
 void Shader::SetVector4f(const char* name, float x, float y, float z, float w, bool useShader) {
-	if (useShader)
-		this->Use();
-	glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+	this->SetVector4f(this->GetUniform(name), glm::vec4(x, y, z, w), useShader);
 }
 
 void Shader::SetMatrix4(const char* name, const glm::mat4 &matrix, bool useShader) {
-	if (useShader)
-		this->Use();
-	glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+	this->SetMatrix4(this->GetUniform(name), matrix, useShader);
 }
 
 
@@ -1,6 +1,7 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <memory>
 #include <string>
 
 //GLM Libs
@@ -8,6 +9,23 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+//Handle of one of a shader's uniforms, resolved once by name with GetUniform.
+//Setting a uniform through its handle doesn't look up or compare any strings.
+struct UniformHandle
+{
+    int Index = -1; //Into the shader's uniform table; -1 if the uniform isn't active
+
+    bool IsValid() const { return this->Index >= 0; }
+};
+
+//Uniforms of a linked program: locations and the last value set (defined in shader.cpp)
+struct UniformTable;
+
+//A shader program. Right after linking it looks up all of its active
+//uniforms, and the setters remember the last value uploaded to each one
+//and skip uploading the same value again. Copies of a Shader share that
+//table, so it stays right whichever copy sets a uniform (as long as all
+//uniform updates go through a Shader).
 class Shader
 {
 public:
@@ -15,7 +33,7 @@ public:
     unsigned int ID;
 
     //constructor
-    Shader() {}
+    Shader() : ID(0) {}
 
     //Set the shader as active
     Shader& Use();
@@ -23,7 +41,24 @@ public:
     //Compile the shader
     void Compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource = nullptr); //Note: Geometry source code is optional
 
-    //Utility
+    //Compile a vertex-only program whose outputs are captured with transform feedback (interleaved, in the given order)
+    void CompileTransformFeedback(const char* vertexSource, const char* const* varyings, int varyingCount);
+
+    //Did the last compile link successfully
+    bool IsLinked() const;
+
+    //Resolve a uniform by name (an invalid handle if the program has no such active uniform)
+    UniformHandle GetUniform(const char* name) const;
+
+    //Set a uniform by handle (of the shader that's in use, unless useShader)
+    void SetFloat(UniformHandle uniform, float value, bool useShader = false);
+    void SetInteger(UniformHandle uniform, int value, bool useShader = false);
+    void SetVector2f(UniformHandle uniform, const glm::vec2& value, bool useShader = false);
+    void SetVector3f(UniformHandle uniform, const glm::vec3& value, bool useShader = false);
+    void SetVector4f(UniformHandle uniform, const glm::vec4& value, bool useShader = false);
+    void SetMatrix4(UniformHandle uniform, const glm::mat4& matrix, bool useShader = false);
+
+    //Set a uniform by name (looks the handle up; fine for setup code)
     void SetFloat(const char* name, float value, bool useShader = false);
     void SetInteger(const char* name, int value, bool useShader = false);
     void SetVector2f(const char* name, float x, float y, bool useShader = false);
@@ -35,10 +70,18 @@ public:
     void SetMatrix4(const char* name, const glm::mat4& matrix, bool useShader = false);
 
 private:
+    //Uniform locations and cached values, shared by all copies
+    std::shared_ptr<UniformTable> uniforms;
 
     //Check if compilation or linking failed and if so print log
     void CheckCompileErrors(unsigned int object, std::string type);
 
+    //Look up all active uniforms of the just linked program
+    void ReflectUniforms();
+
+    //Location to upload a new value to, or -1 if the uniform is invalid or already holds the value
+    int Changed(UniformHandle uniform, const void* value, size_t size);
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in vec4 color;
+layout (location = 3) in float life;
+
+// captured with transform feedback (interleaved, same layout as the input)
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec4 outColor;
+out float outLife;
+
+uniform float dt;
+uniform float fadeRate;
+
+void main()
+{
+    // same rules as ParticlePool::Update; dead slots stay dead and invisible
+    outVelocity = velocity;
+    outLife = life - dt;
+    outPosition = position - velocity * dt;
+    outColor = vec4(color.rgb, color.a - dt * fadeRate);
+    if (outLife <= 0.0)
+    {
+        outLife = 0.0;
+        outPosition = position;
+        outColor.a = 0.0;
+    }
+}
\ No newline at end of file
@@ -1,17 +1,30 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec2 offset;  // per instance
+layout (location = 2) in vec4 color;   // per instance
 
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
-uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
+// frame-global data, one buffer shared by every program (FrameUniforms)
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    float time;
+};
 
 void main()
 {
     float scale = 10.0f;
     TexCoords = vertex.zw;
     ParticleColor = color;
+
+    // dead particles (the GPU backend draws every slot) collapse outside the clip
+    // volume, so they're culled before rasterization instead of blending nothing
+    if (color.a <= 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
     gl_Position = projection * vec4((vertex.xy * scale) + offset, 0.0, 1.0);
 }
\ No newline at end of file
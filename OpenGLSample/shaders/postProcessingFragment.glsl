@@ -7,38 +7,38 @@ uniform vec2 offsets[9];
 uniform int edgeKernel[9];
 uniform float blurKernel[9];
 
-uniform bool chaos;
-uniform bool confuse;
-uniform bool shake;
+// frame-global data, one buffer shared by every program (FrameUniforms)
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    float time;
+};
 
+// compiled once per effect set: CONFUSE, CHAOS and SHAKE are #defined by
+// ResourceManager::LoadShaderVariant (chaos wins over confuse, both over shake)
 void main()
 {
-    color = vec4(0.0f);
+#if defined(CHAOS) || (defined(SHAKE) && !defined(CONFUSE))
+    // sample from texture offsets for the convolution matrix
     vec3 sample[9];
-    // sample from texture offsets if using convolution matrix
-    if(chaos || shake)
-        for(int i = 0; i < 9; i++)
-            sample[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
+    for(int i = 0; i < 9; i++)
+        sample[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
+#endif
 
     // process effects
-    if (chaos)
-    {           
-        for(int i = 0; i < 9; i++)
-            color += vec4(sample[i] * edgeKernel[i], 0.0f);
-        color.a = 1.0f;
-    }
-    else if (confuse)
-    {
-        color = vec4(1.0 - texture(scene, TexCoords).rgb, 1.0);
-    }
-    else if (shake)
-    {
-        for(int i = 0; i < 9; i++)
-            color += vec4(sample[i] * blurKernel[i], 0.0f);
-        color.a = 1.0f;
-    }
-    else
-    {
-        color =  texture(scene, TexCoords);
-    }
+#if defined(CHAOS)
+    color = vec4(0.0f);
+    for(int i = 0; i < 9; i++)
+        color += vec4(sample[i] * edgeKernel[i], 0.0f);
+    color.a = 1.0f;
+#elif defined(CONFUSE)
+    color = vec4(1.0 - texture(scene, TexCoords).rgb, 1.0);
+#elif defined(SHAKE)
+    color = vec4(0.0f);
+    for(int i = 0; i < 9; i++)
+        color += vec4(sample[i] * blurKernel[i], 0.0f);
+    color.a = 1.0f;
+#else
+    color =  texture(scene, TexCoords);
+#endif
 }
\ No newline at end of file
@@ -1,13 +1,21 @@
 #version 330 core
 
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec3 textColor;
 
 out vec2 TexCoords;
+out vec3 TextColor;
 
-uniform mat4 projection;
+// frame-global data, one buffer shared by every program (FrameUniforms)
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    float time;
+};
 
 void main()
 {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
+    TextColor = textColor;
 } 
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "sprite_renderer.hpp"
+#include "gl_state.hpp"
+
+#include <cmath>
+#include <cstddef>
 
 SpriteRenderer::SpriteRenderer(Shader& shader)
+	: DrawCalls(0), texture(0)
 {
 	this->shader = shader;
 	this->InitRenderData();
@@ -9,59 +14,110 @@ SpriteRenderer::SpriteRenderer(Shader& shader)
 SpriteRenderer::~SpriteRenderer()
 {
 	glDeleteVertexArrays(1, &this->quadVAO);
+	glDeleteBuffers(1, &this->VBO);
+	glDeleteBuffers(1, &this->EBO);
 }
 
-void SpriteRenderer::DrawSprite(Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color) {
+void SpriteRenderer::Begin() {
+	this->vertices.clear();
+	this->DrawCalls = 0;
+}
+
+void SpriteRenderer::Submit(const Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color) {
+
+	//A different texture (or a full batch) starts a new batch
+	if (texture.ID != this->texture || this->vertices.size() == MAX_BATCH_SPRITES * 4)
+		this->Flush();
+	this->texture = texture.ID;
+
+	//Corners in texture order: top left, top right, bottom right, bottom left
+	const glm::vec2 corners[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+
+	//Texture coordinates of the corners within the texture's (atlas) region
+	glm::vec2 texCoords[4];
+	for (int i = 0; i < 4; ++i)
+		texCoords[i] = glm::mix(texture.UVMin, texture.UVMax, corners[i]);
+
+	if (rotate == 0.0f) {
+		for (int i = 0; i < 4; ++i)
+			this->vertices.push_back({ position + corners[i] * size, texCoords[i], color });
+	}
+	else {
+		//Rotate around the center of the quad
+		float radians = glm::radians(rotate);
+		float c = std::cos(radians), s = std::sin(radians);
+		glm::vec2 center = position + 0.5f * size;
+
+		for (int i = 0; i < 4; ++i) {
+			glm::vec2 local = (corners[i] - 0.5f) * size;
+			glm::vec2 rotated(local.x * c - local.y * s, local.x * s + local.y * c);
+			this->vertices.push_back({ center + rotated, texCoords[i], color });
+		}
+	}
+}
+
+void SpriteRenderer::Flush() {
+
+	if (this->vertices.empty())
+		return;
 
-	//Prepare transformations
 	this->shader.Use();
-	glm::mat4 model = glm::mat4(1.0f);
-	model = glm::translate(model, glm::vec3(position, 0.0f)); //First Translate -- Transforms happen in reverse order, scale first, then rotation, then translate
 
-	model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f)); //Then set the origin point to the center of the quad. (half width and height)
-	model = glm::rotate(model, glm::radians(rotate), glm::vec3(0.0f, 0.0f, 1.0f)); //Rotate
-	model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f)); //Set the origin back
+	GLState::ActiveTexture(0);
+	GLState::BindTexture2D(this->texture);
 
-	model = glm::scale(model, glm::vec3(size, 1.0f)); //last scale
+	//Orphan the old storage so the driver doesn't wait for the previous draw to finish with it
+	GLState::BindArrayBuffer(this->VBO);
+	glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_SPRITES * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, this->vertices.size() * sizeof(SpriteVertex), this->vertices.data());
 
-	this->shader.SetMatrix4("model", model);
+	//Bindings are left as they are; the state cache skips them if the next batch binds the same
+	GLState::BindVertexArray(this->quadVAO);
+	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(this->vertices.size() / 4 * 6), GL_UNSIGNED_INT, (void*)0);
 
-	//Render the quad (textured)
-	this->shader.SetVector3f("spriteColor", color);
+	this->vertices.clear();
+	++this->DrawCalls;
+}
 
-	glActiveTexture(GL_TEXTURE0);
-	texture.Bind();
+void SpriteRenderer::End() {
+	this->Flush();
+}
 
-	glBindVertexArray(this->quadVAO);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindVertexArray(0); //Unbind
+void SpriteRenderer::DrawSprite(Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color) {
+	this->Submit(texture, position, size, rotate, color);
+	this->Flush();
 }
 
 void SpriteRenderer::InitRenderData() {
 
-	//Configure the VAO/VBO
-	unsigned int VBO;
+	//Two triangles per quad, the same for every batch
+	std::vector<unsigned int> indices;
+	indices.reserve(MAX_BATCH_SPRITES * 6);
+	for (unsigned int quad = 0; quad < MAX_BATCH_SPRITES; ++quad) {
+		unsigned int first = quad * 4;
+		unsigned int quadIndices[] = { first + 3, first + 1, first, first + 3, first + 2, first + 1 };
+		indices.insert(indices.end(), quadIndices, quadIndices + 6);
+	}
+	this->vertices.reserve(MAX_BATCH_SPRITES * 4);
+
+	//Configure the VAO/VBO (vertices are streamed in by Flush)
+	glGenVertexArrays(1, &this->quadVAO);
+	glGenBuffers(1, &this->VBO);
+	glGenBuffers(1, &this->EBO);
 
-	float vertices[] = {
-		// pos      // tex
-		0.0f, 1.0f, 0.0f, 1.0f,
-		1.0f, 0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 0.0f,
+	GLState::BindVertexArray(this->quadVAO);
 
-		0.0f, 1.0f, 0.0f, 1.0f,
-		1.0f, 1.0f, 1.0f, 1.0f,
-		1.0f, 0.0f, 1.0f, 0.0f
-	};
+	GLState::BindArrayBuffer(this->VBO);
+	glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_SPRITES * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
 
-	glGenVertexArrays(1, &this->quadVAO);
-	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	glBindVertexArray(this->quadVAO);
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-}
\ No newline at end of file
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Position)); //Position + TexCoords
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Color));
+
+	GLState::BindVertexArray(0); //The element buffer binding stays with the VAO
+	GLState::BindArrayBuffer(0);
+}
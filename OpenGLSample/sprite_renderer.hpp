@@ -1,6 +1,8 @@
 #ifndef SPRITE_RENDERER_H
 #define SPRITE_RENDERER_H
 
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -8,25 +10,59 @@
 #include "texture.hpp"
 #include "shader.hpp"
 
+//Most sprites in one draw call; a fuller batch is drawn and started over
+const unsigned int MAX_BATCH_SPRITES = 4096;
+
+//Vertex of a batched sprite (already transformed to screen space)
+struct SpriteVertex {
+	glm::vec2 Position;
+	glm::vec2 TexCoords;
+	glm::vec3 Color;
+};
+
+//Draws sprites in batches: Submit only queues a sprite's four vertices,
+//and everything queued is drawn with a single call once the texture
+//changes, the batch is full or it's flushed explicitly.
+//Anything else drawn in between (particles, text) has to Flush first so
+//the order on screen stays the submission order.
 class SpriteRenderer {
 
 public:
+	//Draw calls issued since the last Begin
+	unsigned int DrawCalls;
+
 	//Constructor
 	SpriteRenderer(Shader& shader);
 
 	//Destructor
 	~SpriteRenderer();
 
-	//Renders a defined quad textured with given sprite
+	//Start a new batch (resets the draw call count)
+	void Begin();
+
+	//Queue a quad textured with given sprite
+	void Submit(const Texture2D& texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+
+	//Draw all queued sprites
+	void Flush();
+
+	//Finish the batch (draws what's left)
+	void End();
+
+	//Renders a defined quad textured with given sprite right away
 	void DrawSprite(Texture2D& texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
 
 private:
 	//Render state
 	Shader shader;
-	unsigned int quadVAO;
+	unsigned int quadVAO, VBO, EBO;
+
+	//Current batch
+	std::vector<SpriteVertex> vertices;
+	unsigned int texture; //ID of the queued sprites' texture
 
 	//Init and configure the quad's buffer/vert attributes
 	void InitRenderData();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,8 +1,9 @@
 #include <iostream>
 #include "texture.hpp"
+#include "gl_state.hpp"
 
 Texture2D::Texture2D() 
-	: Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_U(GL_REPEAT), Wrap_V(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR)
+	: Width(0), Height(0), UVMin(0.0f), UVMax(1.0f), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_U(GL_REPEAT), Wrap_V(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR)
 {
 	glGenTextures(1, &this->ID);
 }
@@ -13,7 +14,7 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
 	this->Height = height;
 
 	//Create the texture
-	glBindTexture(GL_TEXTURE_2D, this->ID);
+	GLState::BindTexture2D(this->ID);
 	glTexImage2D(GL_TEXTURE_2D, 0, this->Internal_Format, width, height, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
 
 	//Set Wrap/Filter modes
@@ -23,10 +24,10 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->Filter_Max);
 
 	//Unbind
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::BindTexture2D(0);
 
 }
 
 void Texture2D::Bind() const {
-	glBindTexture(GL_TEXTURE_2D, this->ID);
+	GLState::BindTexture2D(this->ID);
 }
\ No newline at end of file
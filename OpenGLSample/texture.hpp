@@ -2,6 +2,7 @@
 #define TEXTURE_H
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 //Texture2D is able to store and configure a texture in OpenGL.
 //It also hosts utility functions for easy management.
@@ -14,6 +15,9 @@ public:
 	//Image dimensions
 	unsigned int Width, Height;
 
+	//Region of the texture holding the image (a sub-rectangle for atlas entries)
+	glm::vec2 UVMin, UVMax;
+
 	//Format
 	unsigned int Internal_Format; //Format of texture OBJ
 	unsigned int Image_Format; //Format of the loaded image
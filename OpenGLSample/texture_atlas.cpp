@@ -0,0 +1,94 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+TextureAtlas::TextureAtlas(unsigned int pageWidth, unsigned int pageHeight, unsigned int padding)
+	: PageWidth(pageWidth), PageHeight(pageHeight), Padding(padding) {}
+
+unsigned int TextureAtlas::Add(unsigned int width, unsigned int height, const unsigned char* rgba) {
+
+	Image image;
+	image.Width = width;
+	image.Height = height;
+	if (rgba)
+		image.Pixels.assign(rgba, rgba + width * height * 4);
+	this->images.push_back(image);
+
+	return static_cast<unsigned int>(this->images.size() - 1);
+}
+
+bool TextureAtlas::Pack() {
+
+	this->Pages.clear();
+	this->Rects.assign(this->images.size(), AtlasRect());
+
+	//Tallest first keeps the shelves tightly filled
+	std::vector<unsigned int> order(this->images.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+		return this->images[a].Height > this->images[b].Height;
+	});
+
+	unsigned int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+	for (unsigned int index : order) {
+		const Image& image = this->images[index];
+		unsigned int width = image.Width + 2 * this->Padding;
+		unsigned int height = image.Height + 2 * this->Padding;
+
+		if (width > this->PageWidth || height > this->PageHeight) {
+			std::cout << "ERROR::ATLAS: Image of " << image.Width << "x" << image.Height << " doesn't fit a page" << std::endl;
+			return false;
+		}
+
+		//Next shelf if the image doesn't fit the current one, next page if the shelf doesn't fit the page
+		if (shelfX + width > this->PageWidth) {
+			shelfY += shelfHeight;
+			shelfX = shelfHeight = 0;
+		}
+		if (this->Pages.empty() || shelfY + height > this->PageHeight) {
+			this->Pages.emplace_back(this->PageWidth * this->PageHeight * 4, 0);
+			shelfX = shelfY = shelfHeight = 0;
+		}
+
+		AtlasRect& rect = this->Rects[index];
+		rect.Page = static_cast<unsigned int>(this->Pages.size() - 1);
+		rect.X = shelfX + this->Padding;
+		rect.Y = shelfY + this->Padding;
+		rect.Width = image.Width;
+		rect.Height = image.Height;
+		this->Blit(image, rect);
+
+		shelfX += width;
+		shelfHeight = std::max(shelfHeight, height);
+	}
+
+	//Pixels live in the pages now
+	this->images.clear();
+	return true;
+}
+
+void TextureAtlas::Blit(const Image& image, const AtlasRect& rect) {
+
+	//Nothing to copy (e.g. an image that failed to load)
+	if (image.Width == 0 || image.Height == 0)
+		return;
+
+	std::vector<unsigned char>& page = this->Pages[rect.Page];
+	int padding = static_cast<int>(this->Padding);
+
+	for (int y = -padding; y < static_cast<int>(image.Height) + padding; ++y) {
+		//Padding repeats the nearest edge pixel
+		int sourceY = std::min(std::max(y, 0), static_cast<int>(image.Height) - 1);
+
+		for (int x = -padding; x < static_cast<int>(image.Width) + padding; ++x) {
+			int sourceX = std::min(std::max(x, 0), static_cast<int>(image.Width) - 1);
+
+			const unsigned char* source = &image.Pixels[(sourceY * image.Width + sourceX) * 4];
+			unsigned char* destination = &page[((rect.Y + y) * this->PageWidth + rect.X + x) * 4];
+			std::copy(source, source + 4, destination);
+		}
+	}
+}
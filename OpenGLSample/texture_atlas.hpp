@@ -0,0 +1,49 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <vector>
+
+//Where an image ended up in the atlas (pixels)
+struct AtlasRect {
+	unsigned int Page;
+	unsigned int X, Y, Width, Height;
+};
+
+//TextureAtlas packs many small RGBA images into a few large pages so
+//sprites drawn with different images can share one texture (and one
+//batch). Images are placed on shelves, tallest first. It only works on
+//pixels in memory, so it doesn't need an OpenGL context.
+class TextureAtlas {
+
+public:
+	//Page size and the gap around every image (filled with the image's edge
+	//pixels so linear filtering doesn't bleed the neighbours in)
+	unsigned int PageWidth, PageHeight, Padding;
+
+	//Packed pages, RGBA8, PageWidth * PageHeight pixels each
+	std::vector<std::vector<unsigned char>> Pages;
+
+	//Placement of every added image, in the order they were added
+	std::vector<AtlasRect> Rects;
+
+	//Constructor
+	TextureAtlas(unsigned int pageWidth = 2048, unsigned int pageHeight = 2048, unsigned int padding = 2);
+
+	//Queue an RGBA8 image (copied); returns its index into Rects
+	unsigned int Add(unsigned int width, unsigned int height, const unsigned char* rgba);
+
+	//Pack all queued images into pages. False if an image is larger than a page.
+	bool Pack();
+
+private:
+	struct Image {
+		unsigned int Width, Height;
+		std::vector<unsigned char> Pixels;
+	};
+	std::vector<Image> images;
+
+	//Copy an image (and its padding) into its place
+	void Blit(const Image& image, const AtlasRect& rect);
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "worker_pool.hpp"
+
+WorkerPool::WorkerPool(unsigned int threads)
+    : task(nullptr), count(0), next(0), busy(0), job(0), stop(false)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+
+    for (unsigned int i = 1; i < threads; ++i)
+        this->workers.emplace_back(&WorkerPool::Work, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stop = true;
+    }
+    this->wake.notify_all();
+
+    for (std::thread& worker : this->workers)
+        worker.join();
+}
+
+void WorkerPool::Run(unsigned int count, const std::function<void(unsigned int)>& task)
+{
+    // nothing to share
+    if (this->workers.empty() || count < 2)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    // publish the job and help out
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->task = &task;
+        this->count = count;
+        this->next = 0;
+        this->busy = static_cast<unsigned int>(this->workers.size());
+        ++this->job;
+    }
+    this->wake.notify_all();
+
+    this->Drain();
+
+    // the task must outlive every worker that may still be running it
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->done.wait(lock, [this]() { return this->busy == 0; });
+    this->task = nullptr;
+}
+
+void WorkerPool::Work()
+{
+    uint64_t seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [this, seen]() { return this->stop || this->job != seen; });
+            if (this->stop)
+                return;
+            seen = this->job;
+        }
+
+        this->Drain();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->busy == 0)
+            this->done.notify_one();
+    }
+}
+
+void WorkerPool::Drain()
+{
+    for (unsigned int i; (i = this->next++) < this->count;)
+        (*this->task)(i);
+}
@@ -0,0 +1,52 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Fixed set of worker threads for parallel-for style jobs.
+//Run hands out task indices to the workers and the calling thread
+//and returns once every task is done, so the caller never sees a job
+//half finished. Tasks must not depend on the order they run in.
+class WorkerPool {
+
+public:
+	//Constructor (0 threads = one per hardware thread, the caller counts as one)
+	WorkerPool(unsigned int threads = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	//Number of threads taking part in a job (including the caller)
+	unsigned int ThreadCount() const { return static_cast<unsigned int>(this->workers.size()) + 1; }
+
+	//Run task(index) for every index in [0, count) and wait for all of them
+	void Run(unsigned int count, const std::function<void(unsigned int)>& task);
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake, done;
+
+	//Current job
+	const std::function<void(unsigned int)>* task;
+	unsigned int count;
+	std::atomic<unsigned int> next;
+	unsigned int busy;
+	uint64_t job;
+	bool stop;
+
+	//Worker thread body
+	void Work();
+
+	//Take and run tasks of the current job until none are left
+	void Drain();
+};
+
+#endif